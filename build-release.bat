@@ -1,7 +1,7 @@
 @echo off
 echo Building CSOPESY OS Emulator (Release)...
 cd src
-g++ -O2 -DNDEBUG -std=c++17 main.cpp config/config.cpp utils/utils.cpp process/process.cpp scheduler/scheduler.cpp commands/command_processor.cpp memory/memory_manager.cpp -o main.exe
+g++ -O2 -DNDEBUG -std=c++17 main.cpp config/config.cpp utils/utils.cpp utils/clock.cpp benchmark/benchmark.cpp process/process.cpp process/instruction.cpp process/process_archive.cpp scheduler/scheduler.cpp scheduler/simulation.cpp commands/command_processor.cpp memory/memory_manager.cpp memory/backing_store.cpp -o main.exe
 if exist main.exe (
     echo Release build successful! Executable created at main.exe
 ) else (
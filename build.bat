@@ -1,7 +1,7 @@
 @echo off
 echo Building CSOPESY OS Emulator...
 cd src
-g++ -std=c++17 -g main.cpp commands/command_processor.cpp config/config.cpp memory/memory_manager.cpp process/process.cpp scheduler/scheduler.cpp utils/utils.cpp -o main.exe
+g++ -std=c++17 -g main.cpp commands/command_processor.cpp config/config.cpp memory/memory_manager.cpp memory/backing_store.cpp process/process.cpp process/instruction.cpp process/process_archive.cpp scheduler/scheduler.cpp scheduler/simulation.cpp utils/utils.cpp utils/clock.cpp benchmark/benchmark.cpp -o main.exe
 if exist main.exe (
     echo Build successful! Executable created at main.exe
 ) else (
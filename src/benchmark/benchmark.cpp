@@ -0,0 +1,272 @@
+#include "benchmark.h"
+#include "../memory/memory_manager.h"
+#include "../process/process.h"
+#include "../scheduler/work_stealing_deque.h"
+#include "../scheduler/mpmc_queue.h"
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <random>
+#include <filesystem>
+#include <climits>
+#include <mutex>
+#include <atomic>
+
+namespace Benchmark {
+    namespace {
+        const std::string scratchDirectory = "benchmark-scratch";
+    }
+
+    // Each simulated core hammers random pages of its own process while physical
+    // memory holds only a handful of frames, so nearly every access faults and
+    // goes through the backing store.
+    void runFaultThroughput(int maxCores, int maxStripes) {
+        const size_t frameSize = 64;
+        const size_t physicalMemory = frameSize * 8;
+        const size_t processMemory = 1024;
+        const int accessesPerCore = 200;
+
+        std::filesystem::create_directories(scratchDirectory);
+
+        std::cout << "Fault throughput (" << accessesPerCore << " random accesses per core, "
+                  << physicalMemory / frameSize << " frames)" << std::endl;
+        std::cout << std::left << std::setw(10) << "Stripes" << std::setw(8) << "Cores"
+                  << std::setw(10) << "Faults" << std::setw(12) << "Time(ms)" << "Faults/s" << std::endl;
+
+        for (int stripes = 1; stripes <= maxStripes; stripes *= 2) {
+            for (int cores = 1; cores <= maxCores; cores *= 2) {
+                MemoryManager memoryManager(physicalMemory, frameSize, frameSize, processMemory,
+                                            stripes, scratchDirectory + "/backing-store.txt");
+
+                for (int core = 0; core < cores; ++core) {
+                    memoryManager.allocateMemory("bench" + std::to_string(core), processMemory);
+                }
+                size_t faultsBefore = memoryManager.getPageFaults();
+
+                auto start = std::chrono::steady_clock::now();
+                std::vector<std::thread> workers;
+                for (int core = 0; core < cores; ++core) {
+                    workers.emplace_back([&memoryManager, core, processMemory, frameSize]() {
+                        std::mt19937 gen(core + 1);
+                        std::uniform_int_distribution<uint32_t> pageDist(0, processMemory / frameSize - 1);
+                        std::string processId = "bench" + std::to_string(core);
+                        for (int i = 0; i < accessesPerCore; ++i) {
+                            memoryManager.readMemory(processId, pageDist(gen) * frameSize);
+                        }
+                    });
+                }
+                for (auto& worker : workers) {
+                    worker.join();
+                }
+                auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start);
+
+                size_t faults = memoryManager.getPageFaults() - faultsBefore;
+                double seconds = std::max<double>(elapsed.count(), 1) / 1e6;
+
+                std::cout << std::left << std::setw(10) << stripes << std::setw(8) << cores
+                          << std::setw(10) << faults
+                          << std::setw(12) << std::fixed << std::setprecision(1) << elapsed.count() / 1000.0
+                          << std::setprecision(0) << faults / seconds << std::endl;
+            }
+        }
+
+        std::filesystem::remove_all(scratchDirectory);
+    }
+
+    // Every simulated core runs its own generated program repeatedly without a
+    // memory manager or log records, so the numbers reflect dispatch cost:
+    // "text" decodes each instruction from its source line on every step (what
+    // the interpreter originally did), "switch" and "threaded" run the
+    // pre-decoded program through the two interpreter back-ends. Every run()
+    // call here covers the whole program, so these are multi-step numbers:
+    // the scheduler hands the interpreter at most one chunk of
+    // instructions per call (8 when delay-per-exec <= 5, otherwise 1).
+    void runInterpreter(int instructionCount, int passes, int maxCores) {
+        enum class Mode { TEXT, SWITCH, THREADED };
+
+        auto runCore = [instructionCount, passes](Mode mode, size_t& steps) {
+            Process process("bench", 4096);
+            process.generateInstructions(instructionCount, false);
+            const std::vector<Instruction> program = process.program;
+            const std::vector<std::string> sourceLines = process.sourceLines;
+
+            for (int pass = 0; pass < passes; ++pass) {
+                process.restartProgram();
+                while (process.programCounter < program.size()) {
+                    process.state = ProcessState::RUNNING;
+                    if (mode != Mode::TEXT) {
+                        steps += process.run(INT_MAX, false);
+                        continue;
+                    }
+
+                    const Instruction& instruction = program[process.programCounter++];
+                    LogRecord entry;
+                    if (instruction.opcode == Opcode::FOR || instruction.opcode == Opcode::END_FOR) {
+                        process.execute(instruction, entry);
+                    } else {
+                        process.execute(process.decodeInstruction(sourceLines[instruction.source]), entry);
+                    }
+                    if (instruction.opcode != Opcode::END_FOR) {
+                        steps++;
+                    }
+                }
+            }
+        };
+
+        DispatchMode previousMode = Process::getDispatchMode();
+
+        std::cout << "Interpreter throughput (" << instructionCount << " lines x " << passes
+                  << " passes per core, multi-step run() calls)" << std::endl;
+        std::cout << std::left << std::setw(10) << "Dispatch" << std::setw(8) << "Cores" << std::setw(12) << "Steps"
+                  << std::setw(12) << "Time(ms)" << std::setw(14) << "Instr/s" << "Instr/s/core" << std::endl;
+
+        for (Mode mode : {Mode::TEXT, Mode::SWITCH, Mode::THREADED}) {
+            if (mode == Mode::THREADED && !Process::threadedDispatchAvailable()) {
+                std::cout << std::left << std::setw(10) << "threaded" << "not available in this build" << std::endl;
+                continue;
+            }
+            Process::setDispatchMode(mode == Mode::THREADED ? DispatchMode::THREADED : DispatchMode::SWITCH);
+
+            for (int cores = 1; cores <= maxCores; cores *= 2) {
+                std::vector<size_t> steps(cores, 0);
+                auto start = std::chrono::steady_clock::now();
+                std::vector<std::thread> workers;
+                for (int core = 0; core < cores; ++core) {
+                    workers.emplace_back([&runCore, &steps, mode, core]() {
+                        runCore(mode, steps[core]);
+                    });
+                }
+                for (auto& worker : workers) {
+                    worker.join();
+                }
+                auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start);
+
+                size_t totalSteps = 0;
+                for (size_t count : steps) {
+                    totalSteps += count;
+                }
+                double seconds = std::max<double>(elapsed.count(), 1) / 1e6;
+                const char* label = mode == Mode::TEXT ? "text" : (mode == Mode::SWITCH ? "switch" : "threaded");
+
+                std::cout << std::left << std::setw(10) << label << std::setw(8) << cores << std::setw(12) << totalSteps
+                          << std::setw(12) << std::fixed << std::setprecision(1) << elapsed.count() / 1000.0
+                          << std::setprecision(0) << std::setw(14) << totalSteps / seconds
+                          << totalSteps / seconds / cores << std::endl;
+            }
+        }
+
+        Process::setDispatchMode(previousMode);
+    }
+
+    // Each simulated core repeatedly dispatches a process from the ready queue
+    // and puts it straight back, as a core does at the end of a quantum. "global"
+    // is one mutex-protected vector popped with erase(begin()); "stealing" gives
+    // each core a work-stealing deque and lets an empty core steal from the
+    // most loaded one. All processes start on core 0, so the other cores have
+    // to steal their work. "mpmc" is one lock-free ring shared by every core.
+    // Latency is wall time per dispatch as seen by one core.
+    void runRunQueue(int maxCores, int dispatchesPerCore) {
+        const int processesPerCore = 8;
+
+        std::cout << "Run queue dispatch (" << dispatchesPerCore << " dispatches per core, "
+                  << processesPerCore << " processes per core)" << std::endl;
+        std::cout << std::left << std::setw(10) << "Queue" << std::setw(8) << "Cores" << std::setw(12) << "Time(ms)"
+                  << std::setw(16) << "Dispatches/s" << std::setw(14) << "Latency(ns)" << "Steals" << std::endl;
+
+        std::vector<int> processes(static_cast<size_t>(maxCores) * processesPerCore);
+
+        for (int cores = 1; cores <= maxCores; cores *= 2) {
+            for (int mode = 0; mode < 3; ++mode) {
+                std::mutex globalMutex;
+                std::vector<int*> globalQueue;
+                MpmcQueue<int*> sharedQueue(processes.size());
+                std::vector<std::unique_ptr<WorkStealingDeque<int*>>> coreQueues;
+                std::atomic<size_t> steals{0};
+
+                for (int core = 0; core < cores; ++core) {
+                    coreQueues.push_back(std::make_unique<WorkStealingDeque<int*>>());
+                    for (int i = 0; i < processesPerCore; ++i) {
+                        int* process = &processes[core * processesPerCore + i];
+                        if (mode == 0) {
+                            globalQueue.push_back(process);
+                        } else if (mode == 2) {
+                            sharedQueue.push(process);
+                        } else {
+                            coreQueues[0]->push(process);
+                        }
+                    }
+                }
+
+                auto dispatch = [&](int core) -> int* {
+                    int* process = nullptr;
+                    if (mode == 0) {
+                        std::lock_guard<std::mutex> lock(globalMutex);
+                        if (globalQueue.empty()) return nullptr;
+                        process = globalQueue.front();
+                        globalQueue.erase(globalQueue.begin());
+                        return process;
+                    }
+                    if (mode == 2) {
+                        return sharedQueue.pop(process) ? process : nullptr;
+                    }
+                    if (coreQueues[core]->take(process)) return process;
+
+                    WorkStealingDeque<int*>* victim = nullptr;
+                    for (int other = 0; other < cores; ++other) {
+                        if (other != core && (!victim || coreQueues[other]->size() > victim->size())) {
+                            victim = coreQueues[other].get();
+                        }
+                    }
+                    if (victim && victim->take(process)) {
+                        steals++;
+                        return process;
+                    }
+                    return nullptr;
+                };
+
+                auto start = std::chrono::steady_clock::now();
+                std::vector<std::thread> workers;
+                for (int core = 0; core < cores; ++core) {
+                    workers.emplace_back([&, core]() {
+                        for (int i = 0; i < dispatchesPerCore; ) {
+                            int* process = dispatch(core);
+                            if (!process) {
+                                std::this_thread::yield();
+                                continue;
+                            }
+                            (*process)++;
+                            if (mode == 0) {
+                                std::lock_guard<std::mutex> lock(globalMutex);
+                                globalQueue.push_back(process);
+                            } else if (mode == 2) {
+                                sharedQueue.push(process);
+                            } else {
+                                coreQueues[core]->push(process);
+                            }
+                            ++i;
+                        }
+                    });
+                }
+                for (auto& worker : workers) {
+                    worker.join();
+                }
+                auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start);
+
+                double seconds = std::max<double>(elapsed.count(), 1) / 1e6;
+                double dispatches = static_cast<double>(cores) * dispatchesPerCore;
+                const char* label = mode == 0 ? "global" : (mode == 1 ? "stealing" : "mpmc");
+                std::cout << std::left << std::setw(10) << label << std::setw(8) << cores
+                          << std::setw(12) << std::fixed << std::setprecision(1) << elapsed.count() / 1000.0
+                          << std::setw(16) << std::setprecision(0) << dispatches / seconds
+                          << std::setw(14) << seconds * 1e9 * cores / dispatches
+                          << (mode == 1 ? std::to_string(steals.load()) : std::string("-")) << std::endl;
+            }
+        }
+    }
+}
@@ -0,0 +1,10 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+namespace Benchmark {
+    void runFaultThroughput(int maxCores, int maxStripes);
+    void runInterpreter(int instructionCount, int passes, int maxCores);
+    void runRunQueue(int maxCores, int dispatchesPerCore);
+}
+
+#endif
@@ -1,11 +1,15 @@
 #include "command_processor.h"
 #include "../utils/utils.h"
+#include "../utils/clock.h"
 #include "../config/config.h"
+#include "../benchmark/benchmark.h"
+#include "../scheduler/simulation.h"
 #include <iostream>
 #include <sstream>
 #include <algorithm>
 #include <iomanip>
 #include <fstream>
+#include <cctype>
 
 CommandProcessor::CommandProcessor() {
     std::ifstream configFile("config.txt");
@@ -36,6 +40,7 @@ CommandProcessor::CommandProcessor() {
         auto config = std::make_unique<SystemConfig>();
         if (config->loadFromFile(configFile)) {
             config->display();
+            scheduler.reset();
             scheduler = std::make_unique<Scheduler>(std::move(config));
             initialized = true;
             
@@ -62,6 +67,12 @@ CommandProcessor::CommandProcessor() {
         }
         
         try {
+            if (args.size() >= 2 && args[1] == "top") {
+                std::string sortKey = args.size() >= 3 ? args[2] : "rate";
+                scheduler->getMemoryManager()->generateTopReport(sortKey);
+                return;
+            }
+            
             scheduler->getMemoryManager()->generateMemoryReport(
                 scheduler->getRunningProcesses(), 
                 scheduler->getConfig()->numCpu
@@ -171,47 +182,7 @@ CommandProcessor::CommandProcessor() {
             }
             
             if (process) {
-                Utils::clearScreen();
-                Utils::setTextColor(36); 
-                std::cout << "Process name: " << process->name << std::endl;
-                std::cout << "Instruction: Line " << process->executedInstructions << " / " << process->totalInstructions << std::endl;
-                std::cout << "Created at: " << process->creationTimestamp << std::endl;
-                std::cout << "Memory: " << process->allocatedMemory << " bytes" << std::endl;
-                Utils::resetTextColor();
-                
-                std::string input;
-                while (true) {
-                    std::cout << "\n>> ";
-                    std::getline(std::cin, input);
-                    
-                    if (input == "exit") {
-                        displayHeader();
-                        break;
-                    } else if (input == "process-smi") {
-                        std::cout << "\nProcess name: " << process->name << std::endl;
-                        std::cout << "ID: " << process->pid << std::endl;
-                        std::cout << "Memory: " << process->allocatedMemory << " bytes" << std::endl;
-                        std::cout << "Logs:" << std::endl;
-                        
-                        if (!process->instructionHistory.empty()) {
-                            for (const auto& log : process->instructionHistory) {
-                                std::cout << log << std::endl;
-                            }
-                        } else {
-                            std::cout << "No logs found for this process." << std::endl;
-                        }
-                        
-                        std::cout << std::endl;
-                        if (process->state == ProcessState::TERMINATED) {
-                            std::cout << "Finished!" << std::endl;
-                        } else {
-                            std::cout << "Current instruction line: " << process->executedInstructions << std::endl;
-                            std::cout << "Lines of code: " << process->totalInstructions << std::endl;
-                        }
-                    } else {
-                        std::cout << "Available commands: process-smi, exit" << std::endl;
-                    }
-                }
+                runScreenSession(process);
             }
         } else if (args.size() >= 5 && args[1] == "-c") {
             std::string processName = args[2];
@@ -245,41 +216,7 @@ CommandProcessor::CommandProcessor() {
             }
             process = scheduler->findProcess(processName);
             if (process) {
-                Utils::clearScreen();
-                Utils::setTextColor(36); 
-                std::cout << "Process name: " << process->name << std::endl;
-                std::cout << "Instruction: Line " << process->executedInstructions << " / " << process->totalInstructions << std::endl;
-                std::cout << "Created at: " << process->creationTimestamp << std::endl;
-                Utils::resetTextColor();
-                std::string input;
-                while (true) {
-                    std::cout << "\n>> ";
-                    std::getline(std::cin, input);
-                    if (input == "exit") {
-                        displayHeader();
-                        break;
-                    } else if (input == "process-smi") {
-                        std::cout << "\nProcess name: " << process->name << std::endl;
-                        std::cout << "ID: " << process->pid << std::endl;
-                        std::cout << "Logs:" << std::endl;
-                        if (!process->instructionHistory.empty()) {
-                            for (const auto& log : process->instructionHistory) {
-                                std::cout << log << std::endl;
-                            }
-                        } else {
-                            std::cout << "No logs found for this process." << std::endl;
-                        }
-                        std::cout << std::endl;
-                        if (process->state == ProcessState::TERMINATED) {
-                            std::cout << "Finished!" << std::endl;
-                        } else {
-                            std::cout << "Current instruction line: " << process->executedInstructions << std::endl;
-                            std::cout << "Lines of code: " << process->totalInstructions << std::endl;
-                        }
-                    } else {
-                        std::cout << "Available commands: process-smi, exit" << std::endl;
-                    }
-                }
+                runScreenSession(process);
             } else {
                 std::cout << "Process " << processName << " created successfully with " << memorySize << " bytes of memory." << std::endl;
             }
@@ -293,52 +230,19 @@ CommandProcessor::CommandProcessor() {
             }
             
             if (process) {
-                Utils::clearScreen();
-                Utils::setTextColor(36); 
-                std::cout << "Process name: " << process->name << std::endl;
-                std::cout << "Instruction: Line " << process->executedInstructions << " / " << process->totalInstructions << std::endl;
-                std::cout << "Created at: " << process->creationTimestamp << std::endl;
-                Utils::resetTextColor();
-                
-                std::string input;
-                while (true) {
-                    std::cout << "\n>> ";
-                    std::getline(std::cin, input);
-                    
-                    if (input == "exit") {
-                        displayHeader();
-                        break;
-                    } else if (input == "process-smi") {
-                        std::cout << "\nProcess name: " << process->name << std::endl;
-                        std::cout << "ID: " << process->pid << std::endl;
-                        std::cout << "Logs:" << std::endl;
-                        
-                        if (!process->instructionHistory.empty()) {
-                            for (const auto& log : process->instructionHistory) {
-                                std::cout << log << std::endl;
-                            }
-                        } else {
-                            std::cout << "No logs found for this process." << std::endl;
-                        }
-                        
-                        std::cout << std::endl;
-                        if (process->state == ProcessState::TERMINATED) {
-                            std::cout << "Finished!" << std::endl;
-                        } else {
-                            std::cout << "Current instruction line: " << process->executedInstructions << std::endl;
-                            std::cout << "Lines of code: " << process->totalInstructions << std::endl;
-                        }
-                    } else {
-                        std::cout << "Available commands: process-smi, exit" << std::endl;
-                    }
-                }
+                runScreenSession(process);
             }
         } else if (args.size() >= 3 && args[1] == "-r") {
             std::string processName = args[2];
             
             auto process = scheduler->findProcess(processName);
             if (!process) {
-                std::cout << "Process " << processName << " not found." << std::endl;
+                ProcessSummary summary;
+                if (scheduler->getArchive().find(processName, summary)) {
+                    displayArchivedProcess(summary);
+                } else {
+                    std::cout << "Process " << processName << " not found." << std::endl;
+                }
                 return;
             }
             
@@ -351,45 +255,7 @@ CommandProcessor::CommandProcessor() {
                 return;
             }
             
-            Utils::clearScreen();
-            Utils::setTextColor(36); 
-            std::cout << "Process name: " << process->name << std::endl;
-            std::cout << "Instruction: Line " << process->executedInstructions << " / " << process->totalInstructions << std::endl;
-            std::cout << "Created at: " << process->creationTimestamp << std::endl;
-            Utils::resetTextColor();
-            
-            std::string input;
-            while (true) {
-                std::cout << "\n>> ";
-                std::getline(std::cin, input);
-                
-                if (input == "exit") {
-                    displayHeader();
-                    break;
-                } else if (input == "process-smi") {
-                    std::cout << "\nProcess name: " << process->name << std::endl;
-                    std::cout << "ID: " << process->pid << std::endl;
-                    std::cout << "Logs:" << std::endl;
-                    
-                    if (!process->instructionHistory.empty()) {
-                        for (const auto& log : process->instructionHistory) {
-                            std::cout << log << std::endl;
-                        }
-                    } else {
-                        std::cout << "No logs found for this process." << std::endl;
-                    }
-                    
-                    std::cout << std::endl;
-                    if (process->state == ProcessState::TERMINATED) {
-                        std::cout << "Finished!" << std::endl;
-                    } else {
-                        std::cout << "Current instruction line: " << process->executedInstructions << std::endl;
-                        std::cout << "Lines of code: " << process->totalInstructions << std::endl;
-                    }
-                } else {
-                    std::cout << "Available commands: process-smi, exit" << std::endl;
-                }
-            }
+            runScreenSession(process);
         } else {
             std::cout << "Usage:" << std::endl;
             std::cout << "  screen -ls                                        List all processes" << std::endl;
@@ -409,6 +275,100 @@ CommandProcessor::CommandProcessor() {
         scheduler->generateReport(filename);
     };
     
+    commands["benchmark"] = [this](const std::vector<std::string>& args) {
+        try {
+            if (args.size() >= 2 && args[1] == "faults") {
+                int maxCores = args.size() >= 3 ? std::stoi(args[2]) : 8;
+                int maxStripes = args.size() >= 4 ? std::stoi(args[3]) : 4;
+                Benchmark::runFaultThroughput(maxCores, maxStripes);
+                return;
+            }
+            if (args.size() >= 2 && args[1] == "interpreter") {
+                int instructionCount = args.size() >= 3 ? std::stoi(args[2]) : 1000;
+                int passes = args.size() >= 4 ? std::stoi(args[3]) : 200;
+                int maxCores = args.size() >= 5 ? std::stoi(args[4]) : 1;
+                Benchmark::runInterpreter(instructionCount, passes, maxCores);
+                return;
+            }
+            if (args.size() >= 2 && args[1] == "runqueue") {
+                int maxCores = args.size() >= 3 ? std::stoi(args[2]) : 64;
+                int dispatches = args.size() >= 4 ? std::stoi(args[3]) : 20000;
+                Benchmark::runRunQueue(maxCores, dispatches);
+                return;
+            }
+        } catch (const std::exception&) {
+            std::cout << "Invalid benchmark parameters" << std::endl;
+            return;
+        }
+        
+        std::cout << "Usage:" << std::endl;
+        std::cout << "  benchmark faults [max_cores] [max_stripes]       Page fault throughput vs cores and stripes" << std::endl;
+        std::cout << "  benchmark interpreter [ins] [passes] [max_cores] Multi-step instructions/s for text, switch and threaded dispatch" << std::endl;
+        std::cout << "  benchmark runqueue [max_cores] [dispatches]      Ready queue dispatch latency: global, stealing, mpmc" << std::endl;
+    };
+    
+    commands["simulate"] = [this](const std::vector<std::string>& args) {
+        if (!initialized) {
+            std::cout << "Please initialize the system first." << std::endl;
+            return;
+        }
+        
+        // Numbers after the process count are core counts, words are policies.
+        // Every run replays the same seeded workload.
+        size_t processCount = 0;
+        std::vector<int> coreCounts;
+        std::vector<std::string> policies;
+        try {
+            if (args.size() >= 2) processCount = std::stoull(args[1]);
+            for (size_t i = 2; i < args.size(); ++i) {
+                if (std::isdigit(static_cast<unsigned char>(args[i][0]))) {
+                    coreCounts.push_back(std::max(1, std::stoi(args[i])));
+                } else {
+                    policies.push_back(args[i]);
+                }
+            }
+        } catch (const std::exception&) {
+            processCount = 0;
+        }
+        
+        if (processCount == 0) {
+            std::cout << "Usage: simulate <processes> [cores ...] [fcfs|rr|sjf|srtf|mlfq|priority ...]" << std::endl;
+            return;
+        }
+        
+        const SystemConfig& config = *scheduler->getConfig();
+        if (coreCounts.empty()) {
+            coreCounts.push_back(config.numCpu);
+        }
+        if (policies.empty()) {
+            policies.push_back(config.scheduler);
+        }
+        
+        std::cout << "Fast-forward simulation: " << processCount << " processes, q=" << config.quantumCycles
+                  << ", levels=" << config.priorityLevels << ", boost=" << config.boostInterval
+                  << ", arrival every " << config.batchProcessFreq << " tick(s)" << std::endl;
+        std::cout << std::left << std::setw(10) << "Policy" << std::setw(7) << "Cores" << std::setw(12) << "Ticks" << std::setw(8) << "Util%"
+                  << std::setw(11) << "AvgWait" << std::setw(13) << "AvgTurnar." << std::setw(11) << "AvgResp"
+                  << std::setw(11) << "Switches" << std::setw(11) << "Wall(ms)" << "RealTime(s)" << std::endl;
+        
+        for (const auto& policy : policies) {
+            for (int cores : coreCounts) {
+                SystemConfig sweep = config;
+                sweep.scheduler = policy;
+                sweep.numCpu = cores;
+                SimulationResult result = Simulation(sweep, processCount).run();
+                
+                double utilization = result.ticks == 0 ? 0.0 : 100.0 * result.busyTicks / (static_cast<double>(result.ticks) * cores);
+                std::cout << std::fixed << std::setprecision(1) << std::left << std::setw(10) << policy
+                          << std::setw(7) << cores << std::setw(12) << result.ticks << std::setw(8) << utilization
+                          << std::setw(11) << result.averageWaiting << std::setw(13) << result.averageTurnaround
+                          << std::setw(11) << result.averageResponse << std::setw(11) << result.contextSwitches
+                          << std::setw(11) << result.wallMillis << result.ticks / 10 << std::endl;
+            }
+        }
+        std::cout << "Times are in CPU ticks. RealTime is the wall time the same run needs at 100 ms per tick." << std::endl;
+    };
+    
     commands["help"] = [this](const std::vector<std::string>& args) {
         std::cout 
             << "+---------------------------------------------------------------------------------+\n"
@@ -416,6 +376,7 @@ CommandProcessor::CommandProcessor() {
             << "+---------------------------------------------------------------------------------+\n"
             << "|  initialize               - Initialize the processor configuration.             |\n"
             << "|  process-smi              - Show memory and process overview.                   |\n"
+            << "|  process-smi top [key]    - Per-process paging view (rate|faults|rss|in|out).   |\n"
             << "|  vmstat                   - Show detailed memory statistics.                    |\n"
             << "|  screen -s <name> <mem>   - Create process with memory allocation.              |\n"
             << "|  screen -c <name> <mem> \"<cmds>\" - Create process with custom instructions.    |\n"
@@ -427,6 +388,9 @@ CommandProcessor::CommandProcessor() {
             << "|  scheduler-test           - Start scheduler in test mode.                       |\n"
             << "|  scheduler-stop           - Disable automatic dummy process generation.         |\n"
             << "|  report-util              - Save CPU utilization report to file.               |\n"
+            << "|  benchmark <name> [args]  - Run a built-in performance benchmark.               |\n"
+            << "|  simulate <n> [cores...]  - Fast-forward n processes on a virtual tick clock.   |\n"
+            << "|    [policies...]            Compare fcfs/rr/sjf/srtf/mlfq/priority on one load. |\n"
             << "|  clear                    - Clear the screen.                                   |\n"
             << "|  exit                     - Exit the emulator.                                  |\n"
             << "+---------------------------------------------------------------------------------+\n";
@@ -467,10 +431,25 @@ std::vector<std::string> CommandProcessor::parseCommand(const std::string& input
 
 std::vector<std::string> CommandProcessor::parseInstructions(const std::string& instructionString) {
     std::vector<std::string> instructions;
-    std::stringstream ss(instructionString);
-    std::string instruction;
+    std::vector<std::string> statements;
+    std::string current;
+    int bracketDepth = 0;
+    
+    // Semicolons inside a FOR body separate the body's statements, not the
+    // process's top-level instructions.
+    for (char c : instructionString) {
+        if (c == '[') bracketDepth++;
+        if (c == ']' && bracketDepth > 0) bracketDepth--;
+        if (c == ';' && bracketDepth == 0) {
+            statements.push_back(current);
+            current.clear();
+        } else {
+            current += c;
+        }
+    }
+    statements.push_back(current);
     
-    while (std::getline(ss, instruction, ';')) {
+    for (std::string instruction : statements) {
         instruction.erase(0, instruction.find_first_not_of(" \t"));
         instruction.erase(instruction.find_last_not_of(" \t") + 1);
         
@@ -490,6 +469,94 @@ std::vector<std::string> CommandProcessor::parseInstructions(const std::string&
     return instructions;
 }
 
+void CommandProcessor::runScreenSession(const std::shared_ptr<Process>& process) {
+    Utils::clearScreen();
+    Utils::setTextColor(36); 
+    std::cout << "Process name: " << process->name << std::endl;
+    std::cout << "Instruction: Line " << process->executedInstructions << " / " << process->totalInstructions << std::endl;
+    std::cout << "Created at: " << Clock::format(process->creationTimestamp) << std::endl;
+    std::cout << "Memory: " << process->allocatedMemory << " bytes" << std::endl;
+    Utils::resetTextColor();
+    
+    std::string input;
+    while (true) {
+        std::cout << "\n>> ";
+        std::getline(std::cin, input);
+        
+        if (input == "exit") {
+            displayHeader();
+            break;
+        } else if (input == "process-smi") {
+            displayProcessSmi(process);
+        } else {
+            std::cout << "Available commands: process-smi, exit" << std::endl;
+        }
+    }
+}
+
+void CommandProcessor::displayProcessSmi(const std::shared_ptr<Process>& process) {
+    std::cout << "\nProcess name: " << process->name << std::endl;
+    std::cout << "ID: " << process->pid << std::endl;
+    std::cout << "Memory: " << process->allocatedMemory << " bytes" << std::endl;
+    std::cout << "Dispatches: " << process->dispatches << "  Migrations: " << process->migrations << std::endl;
+    
+    ProcessMemoryStats stats;
+    if (scheduler->getMemoryManager()->getProcessMemoryStats(process->pid, stats)) {
+        std::cout << "Resident: " << stats.residentPages << " page(s)"
+                  << "  Page-ins: " << stats.pageIns
+                  << "  Page-outs: " << stats.pageOuts << std::endl;
+        std::cout << "Faults: " << stats.majorFaults << " major, " << stats.minorFaults << " minor"
+                  << "  Fault rate: " << std::fixed << std::setprecision(1) << stats.faultRate() << "%" << std::endl;
+    }
+    
+    std::cout << "Logs:" << std::endl;
+    
+    std::vector<std::string> logs = process->formatLog();
+    if (!logs.empty()) {
+        for (const auto& log : logs) {
+            std::cout << log << std::endl;
+        }
+    } else {
+        std::cout << "No logs found for this process." << std::endl;
+    }
+    
+    std::cout << std::endl;
+    if (process->state == ProcessState::TERMINATED) {
+        std::cout << "Finished!" << std::endl;
+    } else {
+        std::cout << "Current instruction line: " << process->executedInstructions << std::endl;
+        std::cout << "Lines of code: " << process->totalInstructions << std::endl;
+    }
+}
+
+// A finished process is shown from its archive summary, with the log read back
+// from the archive file.
+void CommandProcessor::displayArchivedProcess(const ProcessSummary& summary) {
+    if (summary.memoryViolation) {
+        std::cout << summary.getViolationInfo() << std::endl;
+        return;
+    }
+    
+    std::cout << "Process " << summary.name << " has already finished." << std::endl;
+    std::cout << "\nProcess name: " << summary.name << std::endl;
+    std::cout << "ID: " << summary.pid << std::endl;
+    std::cout << "Memory: " << summary.allocatedMemory << " bytes" << std::endl;
+    std::cout << "Finished at: " << Clock::format(summary.completionTimestamp) << std::endl;
+    std::cout << "Dispatches: " << summary.dispatches << "  Migrations: " << summary.migrations << std::endl;
+    std::cout << "Logs:" << std::endl;
+    
+    std::vector<std::string> logs = scheduler->getArchive().readLog(summary);
+    if (!logs.empty()) {
+        for (const auto& log : logs) {
+            std::cout << log << std::endl;
+        }
+    } else {
+        std::cout << "No logs found for this process." << std::endl;
+    }
+    
+    std::cout << std::endl << "Finished!" << std::endl;
+}
+
 bool CommandProcessor::isValidMemorySize(size_t size) {
     if (!scheduler) return false;
     
@@ -17,6 +17,9 @@ private:
     std::vector<std::string> parseCommand(const std::string& input);
     std::vector<std::string> parseInstructions(const std::string& instructionString);
     bool isValidMemorySize(size_t size);
+    void runScreenSession(const std::shared_ptr<Process>& process);
+    void displayProcessSmi(const std::shared_ptr<Process>& process);
+    void displayArchivedProcess(const ProcessSummary& summary);
     
 public:
     CommandProcessor();
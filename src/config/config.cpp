@@ -4,6 +4,7 @@
 #include <string>
 #include <algorithm>
 #include <vector>
+#include <sstream>
 
 bool SystemConfig::loadFromFile(const std::string& filename) {
     std::cout << "Attempting to load config from: " << filename << std::endl;
@@ -70,6 +71,19 @@ bool SystemConfig::loadFromFile(const std::string& filename) {
             if (key == "num-cpu") numCpu = std::stoi(value);
             else if (key == "scheduler") scheduler = value;
             else if (key == "quantum-cycles") quantumCycles = std::stoi(value);
+            else if (key == "quantum-target") quantumTarget = std::max(0.0, std::stod(value));
+            else if (key == "min-quantum") minQuantum = std::max(1, std::stoi(value));
+            else if (key == "max-quantum") maxQuantum = std::max(1, std::stoi(value));
+            else if (key == "priority-levels") priorityLevels = std::min(64, std::max(1, std::stoi(value)));
+            else if (key == "mlfq-quanta") {
+                std::replace(value.begin(), value.end(), ',', ' ');
+                std::istringstream quanta(value);
+                levelQuanta.clear();
+                for (int quantum; quanta >> quantum; ) {
+                    levelQuanta.push_back(std::max(1, quantum));
+                }
+            }
+            else if (key == "mlfq-boost") boostInterval = std::max(0, std::stoi(value));
             else if (key == "batch-process-freq") batchProcessFreq = std::stoi(value);
             else if (key == "min-ins") minInstructions = std::stoi(value);
             else if (key == "max-ins") maxInstructions = std::stoi(value);
@@ -78,6 +92,21 @@ bool SystemConfig::loadFromFile(const std::string& filename) {
             else if (key == "mem-per-frame") memoryPerFrame = std::stoull(value);
             else if (key == "min-mem-per-proc") minMemoryPerProcess = std::stoull(value);
             else if (key == "max-mem-per-proc") maxMemoryPerProcess = std::stoull(value);
+            else if (key == "backing-store-files") backingStoreFiles = std::max<size_t>(1, std::stoull(value));
+            else if (key == "backing-store-persistent") persistentBackingStore = (value == "true" || value == "1");
+            else if (key == "evict-prefer-idle") evictPreferIdle = (value == "true" || value == "1");
+            else if (key == "interpreter-dispatch") interpreterDispatch = value;
+            else if (key == "synthetic-access") syntheticAccess = value;
+            else if (key == "ready-queue") readyQueue = value;
+            else if (key == "affinity-window") affinityWindow = std::max(0, std::stoi(value));
+            else if (key == "commit-limit") commitLimit = std::stoull(value);
+            else if (key == "admission-limit") admissionLimit = std::stoull(value);
+            else if (key == "admission-order") admissionOrder = value;
+            else if (key == "log-depth") logDepth = std::max<size_t>(1, std::stoull(value));
+            else if (key == "seed") {
+                seed = std::stoull(value);
+                hasSeed = true;
+            }
         } catch (const std::exception& e) {
             std::cerr << "Error parsing config line: " << line << std::endl;
         }
@@ -86,11 +115,35 @@ bool SystemConfig::loadFromFile(const std::string& filename) {
     return true;
 }
 
+// MLFQ quantum of a level. Levels past the end of mlfq-quanta reuse its last
+// entry; without mlfq-quanta the quantum doubles from quantum-cycles per level.
+int SystemConfig::quantumForLevel(int level) const {
+    if (!levelQuanta.empty()) {
+        return levelQuanta[std::min<size_t>(level, levelQuanta.size() - 1)];
+    }
+    return quantumCycles << std::min(level, 16);
+}
+
 void SystemConfig::display() const {
     std::cout << "---- Scheduler Configuration ----" << std::endl;
     std::cout << "Number of CPU Cores   : " << numCpu << std::endl;
     std::cout << "Scheduling Algorithm  : " << scheduler << std::endl;
     std::cout << "Quantum Cycles        : " << quantumCycles << std::endl;
+    if (scheduler == "rr" && quantumTarget > 0) {
+        std::cout << "Adaptive Quantum      : " << quantumTarget << " switches/s (" << minQuantum
+                  << "-" << maxQuantum << " cycles)" << std::endl;
+    }
+    if (scheduler == "mlfq" || scheduler == "priority") {
+        std::cout << "Priority Levels       : " << priorityLevels << std::endl;
+    }
+    if (scheduler == "mlfq") {
+        std::cout << "MLFQ Quanta           :";
+        for (int level = 0; level < priorityLevels; ++level) {
+            std::cout << " " << quantumForLevel(level);
+        }
+        std::cout << std::endl;
+        std::cout << "MLFQ Boost Interval   : " << boostInterval << " ticks" << std::endl;
+    }
     std::cout << "Batch Process Freq    : " << batchProcessFreq << std::endl;
     std::cout << "Min Instructions      : " << minInstructions << std::endl;
     std::cout << "Max Instructions      : " << maxInstructions << std::endl;
@@ -99,5 +152,16 @@ void SystemConfig::display() const {
     std::cout << "Memory per Frame      : " << memoryPerFrame << " bytes" << std::endl;
     std::cout << "Min Memory per Process: " << minMemoryPerProcess << " bytes" << std::endl;
     std::cout << "Max Memory per Process: " << maxMemoryPerProcess << " bytes" << std::endl;
+    std::cout << "Backing Store Files   : " << backingStoreFiles << std::endl;
+    std::cout << "Persistent Store      : " << (persistentBackingStore ? "true" : "false") << std::endl;
+    std::cout << "Evict Prefer Idle     : " << (evictPreferIdle ? "true" : "false") << std::endl;
+    std::cout << "Interpreter Dispatch  : " << interpreterDispatch << std::endl;
+    std::cout << "Ready Queue           : " << readyQueue << std::endl;
+    std::cout << "Affinity Window       : " << affinityWindow << " ticks" << std::endl;
+    std::cout << "Commit Limit          : " << (commitLimit ? std::to_string(commitLimit) + " bytes" : "none") << std::endl;
+    std::cout << "Admission Queue       : " << admissionLimit << " (" << admissionOrder << ")" << std::endl;
+    std::cout << "Synthetic Access      : " << syntheticAccess << std::endl;
+    std::cout << "Process Log Depth     : " << logDepth << " entries" << std::endl;
+    std::cout << "Workload Seed         : " << (hasSeed ? std::to_string(seed) : "random") << std::endl;
     std::cout << "----------------------------------" << std::endl;
 }
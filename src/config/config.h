@@ -2,11 +2,19 @@
 #define CONFIG_H
 
 #include <string>
+#include <vector>
+#include <cstdint>
 
 struct SystemConfig {
     int numCpu = 4;
     std::string scheduler = "fcfs";
     int quantumCycles = 5;
+    double quantumTarget = 0.0;
+    int minQuantum = 1;
+    int maxQuantum = 64;
+    int priorityLevels = 3;
+    std::vector<int> levelQuanta;
+    int boostInterval = 200;
     int batchProcessFreq = 1;
     int minInstructions = 1000;
     int maxInstructions = 2000;
@@ -16,7 +24,21 @@ struct SystemConfig {
     size_t memoryPerFrame = 64;
     size_t minMemoryPerProcess = 64;
     size_t maxMemoryPerProcess = 1024;
+    size_t backingStoreFiles = 1;
+    bool persistentBackingStore = false;
+    bool evictPreferIdle = false;
+    std::string interpreterDispatch = "threaded";
+    size_t logDepth = 100;
+    std::string syntheticAccess = "none";
+    std::string readyQueue = "per-core";
+    int affinityWindow = 50;
+    size_t commitLimit = 0;
+    size_t admissionLimit = 32;
+    std::string admissionOrder = "fifo";
+    bool hasSeed = false;
+    uint64_t seed = 0;
     
+    int quantumForLevel(int level) const;
     bool loadFromFile(const std::string& filename);
     void display() const;
 };
@@ -0,0 +1,540 @@
+#include "backing_store.h"
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <functional>
+#include <iostream>
+#include <set>
+#include <cstring>
+#include <cstdio>
+
+namespace {
+    const char storeMagic[4] = {'C', 'S', 'B', 'S'};
+    const uint32_t storeVersion = 1;
+    const uint32_t recordMagic = 0x45474150;
+    const size_t storeHeaderSize = 16;
+    const std::streamoff generationOffset = 12;
+    const size_t recordHeaderSize = 16 + BackingStore::maxProcessIdLength;
+
+    uint32_t pageChecksum(const std::vector<uint8_t>& data) {
+        uint32_t hash = 2166136261u;
+        for (uint8_t byte : data) {
+            hash ^= byte;
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    std::string slotKey(const std::string& processId, uint32_t pageNumber) {
+        return processId + ":" + std::to_string(pageNumber);
+    }
+}
+
+BackingStore::BackingStore(const std::string& basePath, size_t frameSize, size_t stripeCount,
+                           bool durable, bool resume)
+    : frameSize(frameSize), durable(durable) {
+    if (stripeCount == 0) stripeCount = 1;
+
+    std::string stem = basePath;
+    std::string extension;
+    size_t dot = basePath.rfind('.');
+    if (dot != std::string::npos) {
+        stem = basePath.substr(0, dot);
+        extension = basePath.substr(dot);
+    }
+
+    for (size_t i = 0; i < stripeCount; ++i) {
+        auto stripe = std::make_unique<Stripe>();
+        std::string suffix = (stripeCount == 1) ? "" : "-" + std::to_string(i);
+
+        if (durable) {
+            stripe->path = stem + suffix + ".dat";
+            stripe->indexPath = stripe->path + ".idx";
+            if (!openDurableStripe(*stripe, resume)) {
+                std::cerr << "Warning: cannot open durable backing store " << stripe->path << std::endl;
+            }
+        } else {
+            stripe->path = stem + suffix + extension;
+
+            std::ofstream file(stripe->path, std::ios::binary | std::ios::trunc);
+            if (file.is_open()) {
+                file << "CSOPESY Backing Store - Initialized\n";
+                file.close();
+            }
+        }
+
+        stripes.push_back(std::move(stripe));
+    }
+
+    for (auto& stripe : stripes) {
+        Stripe* s = stripe.get();
+        s->worker = std::thread(&BackingStore::workerLoop, this, std::ref(*s));
+    }
+}
+
+BackingStore::~BackingStore() {
+    for (auto& stripe : stripes) {
+        {
+            std::lock_guard<std::mutex> lock(stripe->queueMutex);
+            stripe->stopping = true;
+        }
+        stripe->queueCV.notify_all();
+    }
+
+    for (auto& stripe : stripes) {
+        if (stripe->worker.joinable()) {
+            stripe->worker.join();
+        }
+        if (durable) {
+            saveSlotIndex(*stripe);
+        }
+    }
+}
+
+BackingStore::Stripe& BackingStore::stripeFor(const std::string& processId, uint32_t pageNumber) {
+    size_t hash = std::hash<std::string>{}(processId);
+    hash ^= static_cast<size_t>(pageNumber) * 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2);
+    return *stripes[hash % stripes.size()];
+}
+
+std::future<bool> BackingStore::submit(Stripe& stripe, IoRequest request) {
+    std::future<bool> result = request.done.get_future();
+    {
+        std::lock_guard<std::mutex> lock(stripe.queueMutex);
+        stripe.queue.push_back(std::move(request));
+    }
+    stripe.queueCV.notify_one();
+    return result;
+}
+
+void BackingStore::writePage(const std::string& processId, uint32_t pageNumber, const std::vector<uint8_t>& data) {
+    IoRequest request;
+    request.type = RequestType::WRITE;
+    request.processId = processId;
+    request.pageNumber = pageNumber;
+    request.data = data;
+    submit(stripeFor(processId, pageNumber), std::move(request));
+}
+
+bool BackingStore::readPage(const std::string& processId, uint32_t pageNumber, std::vector<uint8_t>& data) {
+    IoRequest request;
+    request.type = RequestType::READ;
+    request.processId = processId;
+    request.pageNumber = pageNumber;
+    request.output = &data;
+    return submit(stripeFor(processId, pageNumber), std::move(request)).get();
+}
+
+void BackingStore::removePage(const std::string& processId, uint32_t pageNumber) {
+    IoRequest request;
+    request.type = RequestType::REMOVE;
+    request.processId = processId;
+    request.pageNumber = pageNumber;
+    submit(stripeFor(processId, pageNumber), std::move(request));
+}
+
+void BackingStore::flush() {
+    std::vector<std::future<bool>> pending;
+    for (auto& stripe : stripes) {
+        IoRequest request;
+        request.type = RequestType::FLUSH;
+        pending.push_back(submit(*stripe, std::move(request)));
+    }
+    for (auto& result : pending) {
+        result.wait();
+    }
+}
+
+void BackingStore::workerLoop(Stripe& stripe) {
+    while (true) {
+        IoRequest request;
+        {
+            std::unique_lock<std::mutex> lock(stripe.queueMutex);
+            stripe.queueCV.wait(lock, [&stripe] { return stripe.stopping || !stripe.queue.empty(); });
+            if (stripe.queue.empty()) {
+                return;
+            }
+            request = std::move(stripe.queue.front());
+            stripe.queue.pop_front();
+        }
+
+        bool ok = true;
+        switch (request.type) {
+            case RequestType::WRITE:
+                if (durable) writeDurablePage(stripe, request.processId, request.pageNumber, request.data);
+                else writePageToFile(stripe, request.processId, request.pageNumber, request.data);
+                break;
+            case RequestType::READ:
+                if (durable) ok = readDurablePage(stripe, request.processId, request.pageNumber, *request.output);
+                else ok = readPageFromFile(stripe, request.processId, request.pageNumber, *request.output);
+                break;
+            case RequestType::REMOVE:
+                if (durable) removeDurablePage(stripe, request.processId, request.pageNumber);
+                else removePageFromFile(stripe, request.processId, request.pageNumber);
+                break;
+            case RequestType::FLUSH:
+                if (durable) {
+                    stripe.dataFile.flush();
+                    saveSlotIndex(stripe);
+                }
+                break;
+        }
+        request.done.set_value(ok);
+    }
+}
+
+// Text stripes are append-only: a write adds a new record at the end and
+// moves the page's entry in recordOffsets to it, a removal only drops the
+// entry. Superseded records are dropped by compacting once they outnumber
+// the live ones, so a write costs the record itself rather than the stripe.
+void BackingStore::writePageToFile(Stripe& stripe, const std::string& processId, uint32_t pageNumber, const std::vector<uint8_t>& data) {
+    std::string pageId = "PROCESS=" + processId + " PAGE=" + std::to_string(pageNumber);
+
+    std::ofstream outputFile(stripe.path, std::ios::binary | std::ios::app);
+    if (!outputFile.is_open()) return;
+    outputFile.seekp(0, std::ios::end);
+    std::streamoff offset = outputFile.tellp();
+    outputFile << formatPageRecord(pageId, data);
+    outputFile.close();
+
+    auto it = stripe.recordOffsets.find(pageId);
+    if (it != stripe.recordOffsets.end()) {
+        it->second = offset;
+        stripe.staleRecords++;
+    } else {
+        stripe.recordOffsets[pageId] = offset;
+    }
+
+    if (stripe.staleRecords > stripe.recordOffsets.size() && stripe.staleRecords >= 64) {
+        compactTextStripe(stripe);
+    }
+}
+
+bool BackingStore::readPageFromFile(Stripe& stripe, const std::string& processId, uint32_t pageNumber, std::vector<uint8_t>& data) {
+    std::string pageId = "PROCESS=" + processId + " PAGE=" + std::to_string(pageNumber);
+    auto it = stripe.recordOffsets.find(pageId);
+    if (it == stripe.recordOffsets.end()) return false;
+
+    std::ifstream inputFile(stripe.path, std::ios::binary);
+    if (!inputFile.is_open()) return false;
+    inputFile.seekg(it->second);
+    return readPageRecord(inputFile, pageId, data);
+}
+
+void BackingStore::removePageFromFile(Stripe& stripe, const std::string& processId, uint32_t pageNumber) {
+    std::string pageId = "PROCESS=" + processId + " PAGE=" + std::to_string(pageNumber);
+    if (stripe.recordOffsets.erase(pageId) > 0) {
+        stripe.staleRecords++;
+    }
+}
+
+std::string BackingStore::formatPageRecord(const std::string& pageId, const std::vector<uint8_t>& data) const {
+    std::ostringstream record;
+    record << pageId << "\n";
+    for (size_t i = 0; i < data.size(); ++i) {
+        record << std::hex << std::setfill('0') << std::setw(2) << static_cast<int>(data[i]);
+        if ((i + 1) % 16 == 0) record << "\n";
+        else record << " ";
+    }
+    if (data.size() % 16 != 0) record << "\n";
+    record << "END_PAGE\n";
+    return record.str();
+}
+
+bool BackingStore::readPageRecord(std::istream& in, const std::string& pageId, std::vector<uint8_t>& data) const {
+    std::string line;
+    if (!std::getline(in, line) || line != pageId) return false;
+
+    data.clear();
+    data.resize(frameSize, 0);
+    size_t dataIndex = 0;
+
+    while (std::getline(in, line) && line != "END_PAGE" && dataIndex < frameSize) {
+        std::istringstream iss(line);
+        std::string hexByte;
+
+        while (iss >> hexByte && dataIndex < frameSize) {
+            try {
+                uint8_t byte = static_cast<uint8_t>(std::stoul(hexByte, nullptr, 16));
+                data[dataIndex++] = byte;
+            } catch (const std::exception&) {
+                break;
+            }
+        }
+    }
+
+    return dataIndex > 0;
+}
+
+// Rewrites the stripe with only the latest record of every live page.
+void BackingStore::compactTextStripe(Stripe& stripe) {
+    std::string compactPath = stripe.path + ".compact";
+    std::map<std::string, std::streamoff> offsets;
+    {
+        std::ifstream inputFile(stripe.path, std::ios::binary);
+        std::ofstream outputFile(compactPath, std::ios::binary | std::ios::trunc);
+        if (!inputFile.is_open() || !outputFile.is_open()) return;
+
+        outputFile << "CSOPESY Backing Store - Initialized\n";
+        std::vector<uint8_t> data;
+        for (const auto& entry : stripe.recordOffsets) {
+            inputFile.clear();
+            inputFile.seekg(entry.second);
+            if (!readPageRecord(inputFile, entry.first, data)) continue;
+
+            offsets[entry.first] = outputFile.tellp();
+            outputFile << formatPageRecord(entry.first, data);
+        }
+        if (!outputFile) return;
+    }
+
+    std::remove(stripe.path.c_str());
+    if (std::rename(compactPath.c_str(), stripe.path.c_str()) != 0) {
+        std::cerr << "Warning: cannot compact backing store " << stripe.path << std::endl;
+        return;
+    }
+    stripe.recordOffsets = std::move(offsets);
+    stripe.staleRecords = 0;
+}
+
+std::streamoff BackingStore::slotOffset(uint32_t slot) const {
+    return static_cast<std::streamoff>(storeHeaderSize + static_cast<size_t>(slot) * (recordHeaderSize + frameSize));
+}
+
+bool BackingStore::openDurableStripe(Stripe& stripe, bool resume) {
+    if (resume) {
+        stripe.dataFile.open(stripe.path, std::ios::in | std::ios::out | std::ios::binary);
+        if (stripe.dataFile.is_open()) {
+            char magic[4] = {};
+            uint32_t version = 0, storedFrameSize = 0, generation = 0;
+            stripe.dataFile.read(magic, sizeof(magic));
+            stripe.dataFile.read(reinterpret_cast<char*>(&version), sizeof(version));
+            stripe.dataFile.read(reinterpret_cast<char*>(&storedFrameSize), sizeof(storedFrameSize));
+            stripe.dataFile.read(reinterpret_cast<char*>(&generation), sizeof(generation));
+
+            if (stripe.dataFile && std::memcmp(magic, storeMagic, sizeof(magic)) == 0 &&
+                version == storeVersion && storedFrameSize == frameSize) {
+                stripe.generation = generation;
+                if (loadSlotIndex(stripe)) {
+                    stripe.indexCurrent = true;
+                } else {
+                    rebuildSlotIndex(stripe);
+                }
+                return true;
+            }
+
+            std::cerr << "Warning: backing store " << stripe.path << " does not match this configuration; starting fresh." << std::endl;
+            stripe.dataFile.close();
+        }
+    }
+
+    stripe.dataFile.clear();
+    stripe.dataFile.open(stripe.path, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!stripe.dataFile.is_open()) return false;
+
+    uint32_t version = storeVersion, storedFrameSize = static_cast<uint32_t>(frameSize), generation = 0;
+    stripe.dataFile.write(storeMagic, sizeof(storeMagic));
+    stripe.dataFile.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    stripe.dataFile.write(reinterpret_cast<const char*>(&storedFrameSize), sizeof(storedFrameSize));
+    stripe.dataFile.write(reinterpret_cast<const char*>(&generation), sizeof(generation));
+    stripe.dataFile.flush();
+
+    stripe.slotIndex.clear();
+    stripe.freeSlots.clear();
+    stripe.slotCount = 0;
+    stripe.generation = 0;
+    saveSlotIndex(stripe);
+    return true;
+}
+
+// The index is trusted only if its generation matches the data file's, which
+// moves on the first slot change after every save, and it covers every slot
+// in the file.
+bool BackingStore::loadSlotIndex(Stripe& stripe) {
+    std::ifstream indexFile(stripe.indexPath);
+    if (!indexFile.is_open()) return false;
+
+    size_t storedFrameSize = 0;
+    uint32_t slotCount = 0, generation = 0;
+    std::string line;
+    if (!std::getline(indexFile, line) || line.rfind("CSOPESY Backing Store Index v2 ", 0) != 0) return false;
+    std::istringstream header(line);
+    std::string word;
+    for (int i = 0; i < 5 && header >> word; ++i) {
+    }
+    if (!(header >> storedFrameSize >> slotCount >> generation) || storedFrameSize != frameSize ||
+        generation != stripe.generation) {
+        return false;
+    }
+
+    stripe.dataFile.seekg(0, std::ios::end);
+    std::streamoff fileSize = stripe.dataFile.tellg();
+    if (fileSize != slotOffset(slotCount)) return false;
+
+    std::map<std::string, uint32_t> slotIndex;
+    std::set<uint32_t> usedSlots;
+    while (std::getline(indexFile, line)) {
+        std::istringstream entry(line);
+        std::string processId;
+        uint32_t pageNumber = 0, slot = 0;
+        if (entry >> processId >> pageNumber >> slot && slot < slotCount) {
+            slotIndex[slotKey(processId, pageNumber)] = slot;
+            usedSlots.insert(slot);
+        }
+    }
+
+    stripe.slotIndex = std::move(slotIndex);
+    stripe.slotCount = slotCount;
+    stripe.freeSlots.clear();
+    for (uint32_t slot = 0; slot < slotCount; ++slot) {
+        if (usedSlots.find(slot) == usedSlots.end()) {
+            stripe.freeSlots.push_back(slot);
+        }
+    }
+    return true;
+}
+
+void BackingStore::rebuildSlotIndex(Stripe& stripe) {
+    stripe.dataFile.clear();
+    stripe.dataFile.seekg(0, std::ios::end);
+    std::streamoff fileSize = stripe.dataFile.tellg();
+    uint32_t slotCount = fileSize > static_cast<std::streamoff>(storeHeaderSize)
+        ? static_cast<uint32_t>((fileSize - storeHeaderSize) / (recordHeaderSize + frameSize)) : 0;
+
+    stripe.slotIndex.clear();
+    stripe.freeSlots.clear();
+    stripe.slotCount = slotCount;
+
+    for (uint32_t slot = 0; slot < slotCount; ++slot) {
+        uint32_t header[4] = {};
+        char processId[maxProcessIdLength] = {};
+        stripe.dataFile.seekg(slotOffset(slot));
+        stripe.dataFile.read(reinterpret_cast<char*>(header), sizeof(header));
+        stripe.dataFile.read(processId, sizeof(processId));
+
+        if (stripe.dataFile && header[0] == recordMagic && header[3] <= maxProcessIdLength) {
+            stripe.slotIndex[slotKey(std::string(processId, header[3]), header[2])] = slot;
+        } else {
+            stripe.freeSlots.push_back(slot);
+        }
+        stripe.dataFile.clear();
+    }
+
+    std::cout << "Rebuilt backing store index for " << stripe.path << " (" << stripe.slotIndex.size() << " pages)" << std::endl;
+}
+
+// The data file takes the new generation before the index is written, so an
+// interrupted save leaves the two disagreeing rather than trusting old slots.
+void BackingStore::saveSlotIndex(Stripe& stripe) {
+    stripe.generation++;
+    writeGeneration(stripe);
+
+    std::ofstream indexFile(stripe.indexPath, std::ios::trunc);
+    if (!indexFile.is_open()) return;
+
+    indexFile << "CSOPESY Backing Store Index v2 " << frameSize << " " << stripe.slotCount << " " << stripe.generation << "\n";
+    for (const auto& entry : stripe.slotIndex) {
+        size_t colon = entry.first.rfind(':');
+        indexFile << entry.first.substr(0, colon) << " " << entry.first.substr(colon + 1) << " " << entry.second << "\n";
+    }
+    indexFile.flush();
+    stripe.indexCurrent = static_cast<bool>(indexFile);
+}
+
+// Called before a slot is allocated, reused or freed.
+void BackingStore::markIndexStale(Stripe& stripe) {
+    if (!stripe.indexCurrent) return;
+
+    stripe.generation++;
+    writeGeneration(stripe);
+    stripe.indexCurrent = false;
+}
+
+void BackingStore::writeGeneration(Stripe& stripe) {
+    stripe.dataFile.clear();
+    stripe.dataFile.seekp(generationOffset);
+    stripe.dataFile.write(reinterpret_cast<const char*>(&stripe.generation), sizeof(stripe.generation));
+    stripe.dataFile.flush();
+}
+
+void BackingStore::writeDurablePage(Stripe& stripe, const std::string& processId, uint32_t pageNumber, const std::vector<uint8_t>& data) {
+    if (processId.length() > maxProcessIdLength) {
+        std::cerr << "Error: process id " << processId << " is too long for " << stripe.path
+                  << "; page " << pageNumber << " was not written." << std::endl;
+        return;
+    }
+
+    std::string key = slotKey(processId, pageNumber);
+    uint32_t slot;
+    auto it = stripe.slotIndex.find(key);
+    if (it != stripe.slotIndex.end()) {
+        slot = it->second;
+    } else {
+        markIndexStale(stripe);
+        if (!stripe.freeSlots.empty()) {
+            slot = stripe.freeSlots.back();
+            stripe.freeSlots.pop_back();
+        } else {
+            slot = stripe.slotCount++;
+        }
+        stripe.slotIndex[key] = slot;
+    }
+
+    std::vector<uint8_t> page(data);
+    page.resize(frameSize, 0);
+
+    uint32_t header[4] = {recordMagic, pageChecksum(page), pageNumber, static_cast<uint32_t>(processId.length())};
+    char paddedId[maxProcessIdLength] = {};
+    std::memcpy(paddedId, processId.data(), processId.length());
+
+    stripe.dataFile.clear();
+    stripe.dataFile.seekp(slotOffset(slot));
+    stripe.dataFile.write(reinterpret_cast<const char*>(header), sizeof(header));
+    stripe.dataFile.write(paddedId, sizeof(paddedId));
+    stripe.dataFile.write(reinterpret_cast<const char*>(page.data()), page.size());
+}
+
+bool BackingStore::readDurablePage(Stripe& stripe, const std::string& processId, uint32_t pageNumber, std::vector<uint8_t>& data) {
+    auto it = stripe.slotIndex.find(slotKey(processId, pageNumber));
+    if (it == stripe.slotIndex.end()) return false;
+
+    uint32_t header[4] = {};
+    char storedId[maxProcessIdLength] = {};
+    data.assign(frameSize, 0);
+
+    stripe.dataFile.clear();
+    stripe.dataFile.seekg(slotOffset(it->second));
+    stripe.dataFile.read(reinterpret_cast<char*>(header), sizeof(header));
+    stripe.dataFile.read(storedId, sizeof(storedId));
+    stripe.dataFile.read(reinterpret_cast<char*>(data.data()), frameSize);
+
+    if (!stripe.dataFile || header[0] != recordMagic || header[2] != pageNumber ||
+        header[3] != processId.length() || processId.compare(0, std::string::npos, storedId, header[3]) != 0) {
+        stripe.dataFile.clear();
+        data.assign(frameSize, 0);
+        return false;
+    }
+
+    if (header[1] != pageChecksum(data)) {
+        std::cerr << "Warning: checksum mismatch for " << processId << " page " << pageNumber
+                  << " in " << stripe.path << "; page discarded." << std::endl;
+        data.assign(frameSize, 0);
+        return false;
+    }
+
+    return true;
+}
+
+void BackingStore::removeDurablePage(Stripe& stripe, const std::string& processId, uint32_t pageNumber) {
+    auto it = stripe.slotIndex.find(slotKey(processId, pageNumber));
+    if (it == stripe.slotIndex.end()) return;
+
+    markIndexStale(stripe);
+    uint32_t freed = 0;
+    stripe.dataFile.clear();
+    stripe.dataFile.seekp(slotOffset(it->second));
+    stripe.dataFile.write(reinterpret_cast<const char*>(&freed), sizeof(freed));
+
+    stripe.freeSlots.push_back(it->second);
+    stripe.slotIndex.erase(it);
+}
@@ -0,0 +1,103 @@
+#ifndef BACKING_STORE_H
+#define BACKING_STORE_H
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <future>
+#include <memory>
+#include <map>
+#include <fstream>
+#include <cstdint>
+
+// Pages are striped across one or more text files. Every stripe owns its own
+// request queue and I/O worker, so faults that hash to different stripes are
+// serviced in parallel. Requests within a stripe are handled in FIFO order,
+// which keeps a read consistent with any earlier write of the same page. Text
+// stripes are append-only logs with an in-memory offset per page.
+//
+// In durable mode each stripe is a binary file of fixed-size page slots with a
+// header and a per-page checksum, plus a persisted slot index. Reopening a
+// durable store only loads the index; page data is read when a fault asks.
+// The data file header and the index carry a generation number that moves
+// whenever the slot map changes after the index was saved, so a stale index
+// is detected and rebuilt from the slots.
+class BackingStore {
+public:
+    static const size_t maxProcessIdLength = 32;
+
+    BackingStore(const std::string& basePath, size_t frameSize, size_t stripeCount,
+                 bool durable = false, bool resume = false);
+    ~BackingStore();
+
+    void writePage(const std::string& processId, uint32_t pageNumber, const std::vector<uint8_t>& data);
+    bool readPage(const std::string& processId, uint32_t pageNumber, std::vector<uint8_t>& data);
+    void removePage(const std::string& processId, uint32_t pageNumber);
+    void flush();
+
+    size_t getStripeCount() const { return stripes.size(); }
+    bool isDurable() const { return durable; }
+    bool acceptsProcessId(const std::string& processId) const { return !durable || processId.length() <= maxProcessIdLength; }
+    std::string getStripePath(size_t stripe) const { return stripes[stripe]->path; }
+
+private:
+    enum class RequestType { WRITE, READ, REMOVE, FLUSH };
+
+    struct IoRequest {
+        RequestType type;
+        std::string processId;
+        uint32_t pageNumber = 0;
+        std::vector<uint8_t> data;
+        std::vector<uint8_t>* output = nullptr;
+        std::promise<bool> done;
+    };
+
+    struct Stripe {
+        std::string path;
+        std::string indexPath;
+        std::fstream dataFile;
+        std::map<std::string, uint32_t> slotIndex;
+        std::map<std::string, std::streamoff> recordOffsets;
+        size_t staleRecords = 0;
+        std::vector<uint32_t> freeSlots;
+        uint32_t slotCount = 0;
+        uint32_t generation = 0;
+        bool indexCurrent = false;
+        std::mutex queueMutex;
+        std::condition_variable queueCV;
+        std::deque<IoRequest> queue;
+        bool stopping = false;
+        std::thread worker;
+    };
+
+    size_t frameSize;
+    bool durable;
+    std::vector<std::unique_ptr<Stripe>> stripes;
+
+    Stripe& stripeFor(const std::string& processId, uint32_t pageNumber);
+    std::future<bool> submit(Stripe& stripe, IoRequest request);
+    void workerLoop(Stripe& stripe);
+
+    void writePageToFile(Stripe& stripe, const std::string& processId, uint32_t pageNumber, const std::vector<uint8_t>& data);
+    bool readPageFromFile(Stripe& stripe, const std::string& processId, uint32_t pageNumber, std::vector<uint8_t>& data);
+    void removePageFromFile(Stripe& stripe, const std::string& processId, uint32_t pageNumber);
+    std::string formatPageRecord(const std::string& pageId, const std::vector<uint8_t>& data) const;
+    bool readPageRecord(std::istream& in, const std::string& pageId, std::vector<uint8_t>& data) const;
+    void compactTextStripe(Stripe& stripe);
+
+    bool openDurableStripe(Stripe& stripe, bool resume);
+    bool loadSlotIndex(Stripe& stripe);
+    void rebuildSlotIndex(Stripe& stripe);
+    void saveSlotIndex(Stripe& stripe);
+    void markIndexStale(Stripe& stripe);
+    void writeGeneration(Stripe& stripe);
+    void writeDurablePage(Stripe& stripe, const std::string& processId, uint32_t pageNumber, const std::vector<uint8_t>& data);
+    bool readDurablePage(Stripe& stripe, const std::string& processId, uint32_t pageNumber, std::vector<uint8_t>& data);
+    void removeDurablePage(Stripe& stripe, const std::string& processId, uint32_t pageNumber);
+    std::streamoff slotOffset(uint32_t slot) const;
+};
+
+#endif
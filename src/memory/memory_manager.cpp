@@ -10,8 +10,10 @@
 #include <fstream>
 #include <filesystem>
 
-MemoryManager::MemoryManager(size_t maxMemory, size_t frameSize, size_t minMemPerProc, size_t maxMemPerProc) 
-    : maxOverallMemory(maxMemory), memoryPerFrame(frameSize), 
+MemoryManager::MemoryManager(size_t maxMemory, size_t frameSize, size_t minMemPerProc, size_t maxMemPerProc,
+                             size_t backingStoreFiles, const std::string& storePath,
+                             bool persistentStore, bool resumeStore) 
+    : maxOverallMemory(maxMemory), memoryPerFrame(frameSize), backingStorePath(storePath),
       minMemoryPerProcess(minMemPerProc), maxMemoryPerProcess(maxMemPerProc) {
     totalFrames = maxMemory / frameSize;
     frameTable.reserve(totalFrames);
@@ -21,11 +23,8 @@ MemoryManager::MemoryManager(size_t maxMemory, size_t frameSize, size_t minMemPe
         freeFrames.push(i);
     }
     
-    std::ofstream backingStore(backingStorePath, std::ios::trunc);
-    if (backingStore.is_open()) {
-        backingStore << "CSOPESY Backing Store - Initialized\n";
-        backingStore.close();
-    }
+    backingStore = std::make_unique<BackingStore>(backingStorePath, memoryPerFrame, backingStoreFiles,
+                                                  persistentStore, resumeStore);
 }
 
 MemoryManager::~MemoryManager() {
@@ -37,8 +36,14 @@ bool MemoryManager::isValidMemorySize(size_t size) const {
     return (size & (size - 1)) == 0;
 }
 
+// Whether a request of this size could be granted once enough is freed: it
+// has to fit under the commit limit, or in memory when there is none.
+bool MemoryManager::canEverAllocate(size_t size) const {
+    return isValidMemorySize(size) && size <= (commitLimit > 0 ? commitLimit : maxOverallMemory);
+}
+
 bool MemoryManager::allocateMemory(const std::string& processId, size_t requiredMemory) {
-    std::lock_guard<std::mutex> lock(memoryMutex);
+    std::unique_lock<std::mutex> lock(memoryMutex);
     
     if (!isValidMemorySize(requiredMemory)) {
         return false;
@@ -48,6 +53,21 @@ bool MemoryManager::allocateMemory(const std::string& processId, size_t required
         return false;
     }
     
+    // Durable slots hold the process id in a fixed-width field; a longer id
+    // could never have its pages written back.
+    if (!backingStore->acceptsProcessId(processId)) {
+        std::cerr << "Error: process id " << processId << " is longer than "
+                  << BackingStore::maxProcessIdLength << " characters." << std::endl;
+        return false;
+    }
+    
+    // Virtual memory is backed by the paging file, so only the commit limit,
+    // when set, bounds how much the processes together may allocate.
+    if (commitLimit > 0 && committedMemory + requiredMemory > commitLimit) {
+        return false;
+    }
+    committedMemory += requiredMemory;
+    
     ProcessMemoryInfo memInfo;
     memInfo.processId = processId;
     memInfo.allocatedMemory = requiredMemory;
@@ -56,12 +76,48 @@ bool MemoryManager::allocateMemory(const std::string& processId, size_t required
     processMemoryMap[processId] = memInfo;
     initializeProcessPages(processId, requiredMemory);
     
-    handlePageFaultInternal(processId, 0);
+    handlePageFaultInternal(lock, processId, 0);
+    
+    return true;
+}
+
+// Re-registers a process whose pages already live in a resumed backing store.
+// Nothing is read here; each page is faulted in on first access.
+bool MemoryManager::restoreMemory(const std::string& processId, size_t allocatedSize) {
+    std::lock_guard<std::mutex> lock(memoryMutex);
+    
+    if (processMemoryMap.find(processId) != processMemoryMap.end() || !backingStore->acceptsProcessId(processId)) {
+        return false;
+    }
+    
+    ProcessMemoryInfo memInfo;
+    memInfo.processId = processId;
+    memInfo.allocatedMemory = allocatedSize;
+    committedMemory += allocatedSize;
+    memInfo.baseAddress = processMemoryMap.size() * 0x10000;
+    
+    processMemoryMap[processId] = memInfo;
+    initializeProcessPages(processId, allocatedSize, false);
+    for (auto& page : processMemoryMap[processId].pageTable) {
+        page.second.backed = true;
+    }
     
     return true;
 }
 
-void MemoryManager::initializeProcessPages(const std::string& processId, size_t memorySize) {
+void MemoryManager::checkpointPages() {
+    std::lock_guard<std::mutex> lock(memoryMutex);
+    
+    for (const auto& frame : frameTable) {
+        if (frame.occupied && !frame.loading) {
+            backingStore->writePage(frame.processId, frame.virtualPageNumber, frame.data);
+        }
+    }
+    
+    backingStore->flush();
+}
+
+void MemoryManager::initializeProcessPages(const std::string& processId, size_t memorySize, bool createBackingEntries) {
     size_t pagesNeeded = (memorySize + memoryPerFrame - 1) / memoryPerFrame;
     
     auto& processInfo = processMemoryMap[processId];
@@ -76,7 +132,9 @@ void MemoryManager::initializeProcessPages(const std::string& processId, size_t
         processInfo.pageTable[i] = entry;
         processInfo.validPages.insert(i);
         
-        createInitialBackingStoreEntry(processId, i);
+        if (createBackingEntries) {
+            createInitialBackingStoreEntry(processId, i);
+        }
     }
 }
 
@@ -88,6 +146,8 @@ void MemoryManager::deallocateMemory(const std::string& processId) {
         return;
     }
     
+    releasePins(it->second);
+    
     for (auto& pagePair : it->second.pageTable) {
         uint32_t pageNumber = pagePair.first;
         PageTableEntry& entry = pagePair.second;
@@ -101,65 +161,145 @@ void MemoryManager::deallocateMemory(const std::string& processId) {
         removeBackingStoreEntry(processId, pageNumber);
     }
     
+    committedMemory -= it->second.allocatedMemory;
     processMemoryMap.erase(it);
 }
 
 bool MemoryManager::handlePageFault(const std::string& processId, uint32_t virtualAddress) {
-    std::lock_guard<std::mutex> lock(memoryMutex);
-    return handlePageFaultInternal(processId, virtualAddress);
+    std::unique_lock<std::mutex> lock(memoryMutex);
+    return handlePageFaultInternal(lock, processId, virtualAddress);
 }
 
-bool MemoryManager::handlePageFaultInternal(const std::string& processId, uint32_t virtualAddress) {
-    auto it = processMemoryMap.find(processId);
-    if (it == processMemoryMap.end()) return false;
-    
+// Called with memoryMutex held. The lock is released while the page is read
+// from the backing store so faults on other stripes can proceed; the frame and
+// page table entry are marked as loading until the read completes.
+bool MemoryManager::handlePageFaultInternal(std::unique_lock<std::mutex>& lock, const std::string& processId, uint32_t virtualAddress) {
     uint32_t pageNumber = virtualAddress / memoryPerFrame;
+    uint32_t frameNumber = 0;
     
-    if (it->second.validPages.find(pageNumber) == it->second.validPages.end()) {
-        return false;
+    while (true) {
+        auto it = processMemoryMap.find(processId);
+        if (it == processMemoryMap.end()) return false;
+        
+        if (it->second.validPages.find(pageNumber) == it->second.validPages.end()) {
+            return false;
+        }
+        
+        PageTableEntry& entry = it->second.pageTable[pageNumber];
+        if (entry.valid) return true;
+        
+        if (entry.loading) {
+            pageLoadCV.wait(lock);
+            continue;
+        }
+        
+        if (!freeFrames.empty()) {
+            frameNumber = freeFrames.front();
+            freeFrames.pop();
+            break;
+        }
+        
+        frameNumber = findVictimFrame();
+        if (frameNumber < totalFrames) {
+            evictPageToBackingStore(frameNumber);
+            break;
+        }
+        
+        if (!it->second.pinnedFrames.empty()) {
+            releasePins(it->second);
+            continue;
+        }
+        
+        pageLoadCV.wait(lock);
     }
     
-    uint32_t frameNumber;
+    pageFaults++;
     
-    if (freeFrames.empty()) {
-        frameNumber = findVictimFrame();
-        evictPageToBackingStore(frameNumber);
-    } else {
-        frameNumber = freeFrames.front();
-        freeFrames.pop();
+    MemoryFrame& frame = frameTable[frameNumber];
+    frame.occupied = true;
+    frame.loading = true;
+    frame.processId = processId;
+    frame.virtualPageNumber = pageNumber;
+    frame.lastAccessTime = currentTime;
+    PageTableEntry& faultingEntry = processMemoryMap[processId].pageTable[pageNumber];
+    faultingEntry.loading = true;
+    
+    // A page that has never been paged out is still all zeroes, so it is
+    // filled in place (minor fault) instead of going to the backing store.
+    bool major = faultingEntry.backed;
+    std::vector<uint8_t> pageData;
+    bool loaded = false;
+    if (major) {
+        lock.unlock();
+        loaded = loadPageFromBackingStore(pageData, processId, pageNumber);
+        lock.lock();
     }
     
-    if (!loadPageFromBackingStore(frameNumber, processId, pageNumber)) {
-        frameTable[frameNumber].data.assign(memoryPerFrame, 0);
+    frame.loading = false;
+    
+    auto it = processMemoryMap.find(processId);
+    if (it == processMemoryMap.end()) {
+        frame.occupied = false;
+        frame.processId.clear();
+        freeFrames.push(frameNumber);
+        pageLoadCV.notify_all();
+        return false;
     }
     
-    frameTable[frameNumber].occupied = true;
-    frameTable[frameNumber].processId = processId;
-    frameTable[frameNumber].virtualPageNumber = pageNumber;
-    frameTable[frameNumber].lastAccessTime = currentTime;
+    if (loaded && pageData.size() == memoryPerFrame) {
+        frame.data = std::move(pageData);
+    } else {
+        frame.data.assign(memoryPerFrame, 0);
+    }
     
     PageTableEntry& entry = it->second.pageTable[pageNumber];
+    entry.loading = false;
     entry.valid = true;
     entry.frameNumber = frameNumber;
     entry.referenced = true;
     
+    ProcessMemoryStats& stats = it->second.stats;
+    stats.residentPages++;
+    if (major) {
+        stats.majorFaults++;
+        stats.pageIns++;
+    } else {
+        stats.minorFaults++;
+    }
+    
     pagesPagedIn++;
+    pageLoadCV.notify_all();
     
     return true;
 }
 
+// LRU over frames that are neither loading nor pinned by an in-flight
+// instruction. With preferIdleVictims, frames owned by processes that are not
+// on a core are tried first so a running process does not lose its working set.
 uint32_t MemoryManager::findVictimFrame() {
-    size_t oldestTime = currentTime;
-    uint32_t victimFrame = 0;
-    
-    for (size_t i = 0; i < totalFrames; ++i) {
-        if (frameTable[i].occupied && frameTable[i].lastAccessTime < oldestTime) {
-            oldestTime = frameTable[i].lastAccessTime;
-            victimFrame = i;
+    for (int pass = preferIdleVictims ? 0 : 1; pass < 2; ++pass) {
+        size_t oldestTime = 0;
+        uint32_t victimFrame = totalFrames;
+        
+        for (size_t i = 0; i < totalFrames; ++i) {
+            const MemoryFrame& frame = frameTable[i];
+            if (!frame.occupied || frame.loading || frame.pinCount > 0) continue;
+            
+            if (pass == 0) {
+                auto owner = processMemoryMap.find(frame.processId);
+                if (owner != processMemoryMap.end() && owner->second.running) continue;
+            }
+            
+            if (victimFrame == totalFrames || frame.lastAccessTime < oldestTime) {
+                oldestTime = frame.lastAccessTime;
+                victimFrame = i;
+            }
         }
+        
+        if (victimFrame < totalFrames) return victimFrame;
     }
     
-    return victimFrame;
+    return totalFrames;
 }
 
 void MemoryManager::evictPageToBackingStore(uint32_t frameNumber) {
@@ -168,15 +308,24 @@ void MemoryManager::evictPageToBackingStore(uint32_t frameNumber) {
     std::string processId = frameTable[frameNumber].processId;
     uint32_t pageNumber = frameTable[frameNumber].virtualPageNumber;
     
-    writePageToBackingStore(processId, pageNumber, frameTable[frameNumber].data);
+    backingStore->writePage(processId, pageNumber, frameTable[frameNumber].data);
     
     auto it = processMemoryMap.find(processId);
     if (it != processMemoryMap.end()) {
+        if (it->second.running) {
+            evictedWhileRunning++;
+        }
+        
         auto pageIt = it->second.pageTable.find(pageNumber);
         if (pageIt != it->second.pageTable.end()) {
             pageIt->second.valid = false;
             pageIt->second.frameNumber = 0;
+            pageIt->second.backed = true;
         }
+        
+        ProcessMemoryStats& stats = it->second.stats;
+        if (stats.residentPages > 0) stats.residentPages--;
+        stats.pageOuts++;
     }
     
     frameTable[frameNumber].occupied = false;
@@ -184,141 +333,21 @@ void MemoryManager::evictPageToBackingStore(uint32_t frameNumber) {
     pagesPagedOut++;
 }
 
-bool MemoryManager::loadPageFromBackingStore(uint32_t frameNumber, const std::string& processId, uint32_t virtualPageNumber) {
-    return readPageFromBackingStore(processId, virtualPageNumber, frameTable[frameNumber].data);
+bool MemoryManager::loadPageFromBackingStore(std::vector<uint8_t>& data, const std::string& processId, uint32_t virtualPageNumber) {
+    return backingStore->readPage(processId, virtualPageNumber, data);
 }
 
 void MemoryManager::createInitialBackingStoreEntry(const std::string& processId, uint32_t pageNumber) {
     std::vector<uint8_t> initialData(memoryPerFrame, 0);
-    writePageToBackingStore(processId, pageNumber, initialData);
-}
-
-void MemoryManager::writePageToBackingStore(const std::string& processId, uint32_t pageNumber, const std::vector<uint8_t>& data) {
-    std::lock_guard<std::mutex> lock(backingStoreMutex);
-    
-    std::vector<std::string> lines;
-    std::ifstream inputFile(backingStorePath);
-    std::string line;
-    bool found = false;
-    std::string pageId = "PROCESS=" + processId + " PAGE=" + std::to_string(pageNumber);
-    
-    while (std::getline(inputFile, line)) {
-        if (line.find(pageId) != std::string::npos) {
-            found = true;
-            lines.push_back(pageId);
-            
-            std::ostringstream dataStream;
-            for (size_t i = 0; i < data.size(); ++i) {
-                dataStream << std::hex << std::setfill('0') << std::setw(2) << static_cast<int>(data[i]);
-                if ((i + 1) % 16 == 0) dataStream << "\n";
-                else dataStream << " ";
-            }
-            if (data.size() % 16 != 0) dataStream << "\n";
-            dataStream << "END_PAGE\n";
-            
-            lines.push_back(dataStream.str());
-            
-            while (std::getline(inputFile, line) && line != "END_PAGE") {
-            }
-        } else {
-            lines.push_back(line);
-        }
-    }
-    inputFile.close();
-    
-    if (!found) {
-        lines.push_back(pageId);
-        
-        std::ostringstream dataStream;
-        for (size_t i = 0; i < data.size(); ++i) {
-            dataStream << std::hex << std::setfill('0') << std::setw(2) << static_cast<int>(data[i]);
-            if ((i + 1) % 16 == 0) dataStream << "\n";
-            else dataStream << " ";
-        }
-        if (data.size() % 16 != 0) dataStream << "\n";
-        dataStream << "END_PAGE";
-        
-        lines.push_back(dataStream.str());
-    }
-    
-    std::ofstream outputFile(backingStorePath);
-    for (const auto& outputLine : lines) {
-        outputFile << outputLine << "\n";
-    }
-    outputFile.close();
-}
-
-bool MemoryManager::readPageFromBackingStore(const std::string& processId, uint32_t pageNumber, std::vector<uint8_t>& data) {
-    std::lock_guard<std::mutex> lock(backingStoreMutex);
-    
-    std::ifstream inputFile(backingStorePath);
-    if (!inputFile.is_open()) return false;
-    
-    std::string line;
-    std::string pageId = "PROCESS=" + processId + " PAGE=" + std::to_string(pageNumber);
-    bool found = false;
-    
-    while (std::getline(inputFile, line)) {
-        if (line.find(pageId) != std::string::npos) {
-            found = true;
-            break;
-        }
-    }
-    
-    if (!found) {
-        inputFile.close();
-        return false;
-    }
-    
-    data.clear();
-    data.resize(memoryPerFrame, 0);
-    size_t dataIndex = 0;
-    
-    while (std::getline(inputFile, line) && line != "END_PAGE" && dataIndex < memoryPerFrame) {
-        std::istringstream iss(line);
-        std::string hexByte;
-        
-        while (iss >> hexByte && dataIndex < memoryPerFrame) {
-            try {
-                uint8_t byte = static_cast<uint8_t>(std::stoul(hexByte, nullptr, 16));
-                data[dataIndex++] = byte;
-            } catch (const std::exception&) {
-                break;
-            }
-        }
-    }
-    
-    inputFile.close();
-    return dataIndex > 0;
+    backingStore->writePage(processId, pageNumber, initialData);
 }
 
 void MemoryManager::removeBackingStoreEntry(const std::string& processId, uint32_t pageNumber) {
-    std::lock_guard<std::mutex> lock(backingStoreMutex);
-    
-    std::vector<std::string> lines;
-    std::ifstream inputFile(backingStorePath);
-    std::string line;
-    std::string pageId = "PROCESS=" + processId + " PAGE=" + std::to_string(pageNumber);
-    
-    while (std::getline(inputFile, line)) {
-        if (line.find(pageId) != std::string::npos) {
-            while (std::getline(inputFile, line) && line != "END_PAGE") {
-            }
-        } else {
-            lines.push_back(line);
-        }
-    }
-    inputFile.close();
-    
-    std::ofstream outputFile(backingStorePath);
-    for (const auto& outputLine : lines) {
-        outputFile << outputLine << "\n";
-    }
-    outputFile.close();
+    backingStore->removePage(processId, pageNumber);
 }
 
 uint16_t MemoryManager::readMemory(const std::string& processId, uint32_t address) {
-    std::lock_guard<std::mutex> lock(memoryMutex);
+    std::unique_lock<std::mutex> lock(memoryMutex);
     
     auto it = processMemoryMap.find(processId);
     if (it == processMemoryMap.end()) return 0;
@@ -334,14 +363,17 @@ uint16_t MemoryManager::readMemory(const std::string& processId, uint32_t addres
         return 0;
     }
     
+    it->second.stats.accesses++;
     uint32_t pageNumber = address / memoryPerFrame;
     uint32_t offset = address % memoryPerFrame;
     
     auto pageIt = it->second.pageTable.find(pageNumber);
     if (pageIt == it->second.pageTable.end() || !pageIt->second.valid) {
-        if (!const_cast<MemoryManager*>(this)->handlePageFaultInternal(processId, address)) {
+        if (!handlePageFaultInternal(lock, processId, address)) {
             return 0;
         }
+        it = processMemoryMap.find(processId);
+        if (it == processMemoryMap.end()) return 0;
         pageIt = it->second.pageTable.find(pageNumber);
     }
     
@@ -350,6 +382,7 @@ uint16_t MemoryManager::readMemory(const std::string& processId, uint32_t addres
     
     frameTable[frameNumber].lastAccessTime = currentTime;
     pageIt->second.referenced = true;
+    touchFrame(it->second, frameNumber);
     
     uint16_t value = frameTable[frameNumber].data[offset] | 
                     (static_cast<uint16_t>(frameTable[frameNumber].data[offset + 1]) << 8);
@@ -357,7 +390,7 @@ uint16_t MemoryManager::readMemory(const std::string& processId, uint32_t addres
 }
 
 bool MemoryManager::writeMemory(const std::string& processId, uint32_t address, uint16_t value) {
-    std::lock_guard<std::mutex> lock(memoryMutex);
+    std::unique_lock<std::mutex> lock(memoryMutex);
     
     auto it = processMemoryMap.find(processId);
     if (it == processMemoryMap.end()) return false;
@@ -373,14 +406,17 @@ bool MemoryManager::writeMemory(const std::string& processId, uint32_t address,
         return false;
     }
     
+    it->second.stats.accesses++;
     uint32_t pageNumber = address / memoryPerFrame;
     uint32_t offset = address % memoryPerFrame;
     
     auto pageIt = it->second.pageTable.find(pageNumber);
     if (pageIt == it->second.pageTable.end() || !pageIt->second.valid) {
-        if (!handlePageFaultInternal(processId, address)) {
+        if (!handlePageFaultInternal(lock, processId, address)) {
             return false;
         }
+        it = processMemoryMap.find(processId);
+        if (it == processMemoryMap.end()) return false;
         pageIt = it->second.pageTable.find(pageNumber);
     }
     
@@ -389,6 +425,7 @@ bool MemoryManager::writeMemory(const std::string& processId, uint32_t address,
     
     frameTable[frameNumber].lastAccessTime = currentTime;
     pageIt->second.referenced = true;
+    touchFrame(it->second, frameNumber);
     pageIt->second.modified = true;
     
     frameTable[frameNumber].data[offset] = value & 0xFF;
@@ -398,7 +435,7 @@ bool MemoryManager::writeMemory(const std::string& processId, uint32_t address,
 }
 
 bool MemoryManager::accessMemory(const std::string& processId, uint32_t address) {
-    std::lock_guard<std::mutex> lock(memoryMutex);
+    std::unique_lock<std::mutex> lock(memoryMutex);
     
     auto it = processMemoryMap.find(processId);
     if (it == processMemoryMap.end()) return false;
@@ -414,13 +451,16 @@ bool MemoryManager::accessMemory(const std::string& processId, uint32_t address)
         return false;
     }
     
+    it->second.stats.accesses++;
     uint32_t pageNumber = address / memoryPerFrame;
     
     auto pageIt = it->second.pageTable.find(pageNumber);
     if (pageIt == it->second.pageTable.end() || !pageIt->second.valid) {
-        if (!handlePageFaultInternal(processId, address)) {
+        if (!handlePageFaultInternal(lock, processId, address)) {
             return false;
         }
+        it = processMemoryMap.find(processId);
+        if (it == processMemoryMap.end()) return false;
         pageIt = it->second.pageTable.find(pageNumber);
     }
     
@@ -429,55 +469,71 @@ bool MemoryManager::accessMemory(const std::string& processId, uint32_t address)
     
     frameTable[frameNumber].lastAccessTime = currentTime;
     pageIt->second.referenced = true;
+    touchFrame(it->second, frameNumber);
     
     return true;
 }
 
-bool MemoryManager::declareVariable(const std::string& processId, const std::string& varName, uint16_t value) {
+// Frames touched between beginInstructionAccess and endInstructionAccess stay
+// pinned, so a later fault within the same instruction cannot evict a page the
+// instruction already depends on.
+void MemoryManager::beginInstructionAccess(const std::string& processId) {
     std::lock_guard<std::mutex> lock(memoryMutex);
     
     auto it = processMemoryMap.find(processId);
-    if (it == processMemoryMap.end()) return false;
-    
-    if (it->second.symbolTableUsed >= 64) {
-        return false;
-    }
-    
-    if (it->second.symbolTable.find(varName) != it->second.symbolTable.end()) {
-        it->second.symbolTable[varName] = value;
-        return true;
-    }
+    if (it == processMemoryMap.end()) return;
     
-    it->second.symbolTable[varName] = value;
-    it->second.symbolTableUsed += 2;
-    
-    return true;
+    it->second.pinningActive = true;
 }
 
-bool MemoryManager::getVariable(const std::string& processId, const std::string& varName, uint16_t& value) {
+void MemoryManager::endInstructionAccess(const std::string& processId) {
     std::lock_guard<std::mutex> lock(memoryMutex);
     
     auto it = processMemoryMap.find(processId);
-    if (it == processMemoryMap.end()) return false;
+    if (it == processMemoryMap.end()) return;
     
-    auto varIt = it->second.symbolTable.find(varName);
-    if (varIt == it->second.symbolTable.end()) return false;
-    
-    value = varIt->second;
-    return true;
+    it->second.pinningActive = false;
+    releasePins(it->second);
 }
 
-bool MemoryManager::setVariable(const std::string& processId, const std::string& varName, uint16_t value) {
+void MemoryManager::setProcessRunning(const std::string& processId, bool running) {
     std::lock_guard<std::mutex> lock(memoryMutex);
     
     auto it = processMemoryMap.find(processId);
-    if (it == processMemoryMap.end()) return false;
+    if (it == processMemoryMap.end()) return;
     
-    auto varIt = it->second.symbolTable.find(varName);
-    if (varIt == it->second.symbolTable.end()) return false;
+    it->second.running = running;
+}
+
+void MemoryManager::touchFrame(ProcessMemoryInfo& info, uint32_t frameNumber) {
+    if (!info.pinningActive) return;
     
-    varIt->second = value;
-    return true;
+    if (std::find(info.pinnedFrames.begin(), info.pinnedFrames.end(), frameNumber) != info.pinnedFrames.end()) {
+        return;
+    }
+    
+    frameTable[frameNumber].pinCount++;
+    info.pinnedFrames.push_back(frameNumber);
+}
+
+void MemoryManager::releasePins(ProcessMemoryInfo& info) {
+    if (info.pinnedFrames.empty()) return;
+    
+    for (uint32_t frameNumber : info.pinnedFrames) {
+        if (frameTable[frameNumber].pinCount > 0) {
+            frameTable[frameNumber].pinCount--;
+        }
+    }
+    info.pinnedFrames.clear();
+    pageLoadCV.notify_all();
+}
+
+size_t MemoryManager::getPinnedFrameCount() const {
+    size_t pinned = 0;
+    for (const auto& frame : frameTable) {
+        if (frame.pinCount > 0) pinned++;
+    }
+    return pinned;
 }
 
 size_t MemoryManager::getUsedMemory() const {
@@ -505,7 +561,7 @@ void MemoryManager::generateMemoryReport(const std::vector<std::shared_ptr<Proce
     for (const auto& pair : processMemoryMap) {
         bool isActiveProcess = false;
         for (const auto& process : runningProcesses) {
-            if (process != nullptr && process->name == pair.first) {
+            if (process != nullptr && process->pid == pair.first) {
                 if (process->state != ProcessState::TERMINATED) {
                     isActiveProcess = true;
                     break;
@@ -541,7 +597,7 @@ void MemoryManager::generateMemoryReport(const std::vector<std::shared_ptr<Proce
     for (const auto& pair : processMemoryMap) {
         bool isActiveProcess = false;
         for (const auto& process : runningProcesses) {
-            if (process != nullptr && process->name == pair.first) {
+            if (process != nullptr && process->pid == pair.first) {
                 if (process->state != ProcessState::TERMINATED) {
                     isActiveProcess = true;
                     break;
@@ -550,8 +606,15 @@ void MemoryManager::generateMemoryReport(const std::vector<std::shared_ptr<Proce
         }
         
         if (isActiveProcess) {
+            const ProcessMemoryStats& stats = pair.second.stats;
             std::cout << std::left << std::setw(20) << pair.first 
-                      << std::right << std::setw(10) << pair.second.allocatedMemory << " bytes" << std::endl;
+                      << std::right << std::setw(10) << pair.second.allocatedMemory << " bytes"
+                      << "  RSS " << std::setw(6) << stats.residentPages * memoryPerFrame
+                      << "  in " << std::setw(5) << stats.pageIns
+                      << "  out " << std::setw(5) << stats.pageOuts
+                      << "  maj " << std::setw(5) << stats.majorFaults
+                      << "  min " << std::setw(5) << stats.minorFaults
+                      << "  rate " << std::fixed << std::setprecision(1) << stats.faultRate() << "%" << std::endl;
             hasActiveProcesses = true;
         }
     }
@@ -584,6 +647,56 @@ void MemoryManager::generateVmstatReport() {
     std::cout << "Total CPU ticks: " << totalCpuTicks << std::endl;
     std::cout << "Num paged in: " << pagesPagedIn << std::endl;
     std::cout << "Num paged out: " << pagesPagedOut << std::endl;
+    std::cout << "Pinned frames: " << getPinnedFrameCount() << std::endl;
+    std::cout << "Evicted while running: " << evictedWhileRunning << std::endl;
+}
+
+// top-style view of every process that currently holds memory, worst first.
+void MemoryManager::generateTopReport(const std::string& sortKey) {
+    std::vector<std::pair<std::string, ProcessMemoryStats>> rows;
+    {
+        std::lock_guard<std::mutex> lock(memoryMutex);
+        for (const auto& pair : processMemoryMap) {
+            rows.emplace_back(pair.first, pair.second.stats);
+        }
+    }
+    
+    auto key = [&sortKey](const ProcessMemoryStats& stats) -> double {
+        if (sortKey == "faults") return static_cast<double>(stats.faults());
+        if (sortKey == "rss") return static_cast<double>(stats.residentPages);
+        if (sortKey == "in") return static_cast<double>(stats.pageIns);
+        if (sortKey == "out") return static_cast<double>(stats.pageOuts);
+        return stats.faultRate();
+    };
+    std::stable_sort(rows.begin(), rows.end(), [&key](const auto& a, const auto& b) {
+        return key(a.second) > key(b.second);
+    });
+    
+    std::cout << "Processes by " << (sortKey.empty() ? "rate" : sortKey) << " (" << rows.size() << " with memory)" << std::endl;
+    std::cout << std::left << std::setw(10) << "PID" << std::right
+              << std::setw(8) << "RSS" << std::setw(8) << "IN" << std::setw(8) << "OUT"
+              << std::setw(8) << "MAJFLT" << std::setw(8) << "MINFLT"
+              << std::setw(10) << "ACCESS" << std::setw(9) << "RATE" << std::endl;
+    
+    for (const auto& row : rows) {
+        const ProcessMemoryStats& stats = row.second;
+        std::cout << std::left << std::setw(10) << row.first << std::right
+                  << std::setw(8) << stats.residentPages * memoryPerFrame
+                  << std::setw(8) << stats.pageIns << std::setw(8) << stats.pageOuts
+                  << std::setw(8) << stats.majorFaults << std::setw(8) << stats.minorFaults
+                  << std::setw(10) << stats.accesses
+                  << std::setw(8) << std::fixed << std::setprecision(1) << stats.faultRate() << "%" << std::endl;
+    }
+}
+
+bool MemoryManager::getProcessMemoryStats(const std::string& processId, ProcessMemoryStats& stats) {
+    std::lock_guard<std::mutex> lock(memoryMutex);
+    
+    auto it = processMemoryMap.find(processId);
+    if (it == processMemoryMap.end()) return false;
+    
+    stats = it->second.stats;
+    return true;
 }
 
 bool MemoryManager::hasMemoryViolation(const std::string& processId) const {
@@ -9,12 +9,16 @@
 #include <fstream>
 #include <set>
 #include <memory>
+#include <condition_variable>
+#include "backing_store.h"
 
 struct PageTableEntry {
     bool valid = false;
     uint32_t frameNumber = 0;
     bool referenced = false;
     bool modified = false;
+    bool loading = false;
+    bool backed = false;
 };
 
 struct MemoryFrame {
@@ -23,21 +27,37 @@ struct MemoryFrame {
     uint32_t virtualPageNumber = 0;
     std::vector<uint8_t> data;
     size_t lastAccessTime = 0;
+    bool loading = false;
+    int pinCount = 0;
     
     MemoryFrame(size_t frameSize) : data(frameSize, 0) {}
 };
 
+struct ProcessMemoryStats {
+    size_t residentPages = 0;
+    size_t pageIns = 0;
+    size_t pageOuts = 0;
+    size_t majorFaults = 0;
+    size_t minorFaults = 0;
+    size_t accesses = 0;
+    
+    size_t faults() const { return majorFaults + minorFaults; }
+    double faultRate() const { return accesses == 0 ? 0.0 : 100.0 * faults() / accesses; }
+};
+
 struct ProcessMemoryInfo {
     std::string processId;
     size_t allocatedMemory = 0;
     uint32_t baseAddress = 0;
     std::map<uint32_t, PageTableEntry> pageTable;
-    std::map<std::string, uint16_t> symbolTable;
     bool memoryViolationOccurred = false;
     std::string violationTimestamp;
     uint32_t violationAddress = 0;
-    size_t symbolTableUsed = 0;
     std::set<uint32_t> validPages;
+    bool running = false;
+    bool pinningActive = false;
+    std::vector<uint32_t> pinnedFrames;
+    ProcessMemoryStats stats;
 };
 
 class MemoryManager {
@@ -48,9 +68,10 @@ private:
     std::vector<MemoryFrame> frameTable;
     std::queue<uint32_t> freeFrames;
     std::map<std::string, ProcessMemoryInfo> processMemoryMap;
-    std::string backingStorePath = "csopesy-backing-store.txt";
+    std::string backingStorePath;
+    std::unique_ptr<BackingStore> backingStore;
     std::mutex memoryMutex;
-    std::mutex backingStoreMutex;
+    std::condition_variable pageLoadCV;
     
     size_t minMemoryPerProcess;
     size_t maxMemoryPerProcess;
@@ -62,35 +83,49 @@ private:
     size_t pagesPagedOut = 0;
     size_t pageFaults = 0;
     size_t currentTime = 0;
+    size_t evictedWhileRunning = 0;
+    bool preferIdleVictims = false;
+    size_t commitLimit = 0;
+    size_t committedMemory = 0;
     
     uint32_t findVictimFrame();
     void evictPageToBackingStore(uint32_t frameNumber);
-    bool loadPageFromBackingStore(uint32_t frameNumber, const std::string& processId, uint32_t virtualPageNumber);
-    bool handlePageFaultInternal(const std::string& processId, uint32_t virtualAddress);
-    void writePageToBackingStore(const std::string& processId, uint32_t pageNumber, const std::vector<uint8_t>& data);
-    bool readPageFromBackingStore(const std::string& processId, uint32_t pageNumber, std::vector<uint8_t>& data);
+    bool loadPageFromBackingStore(std::vector<uint8_t>& data, const std::string& processId, uint32_t virtualPageNumber);
+    bool handlePageFaultInternal(std::unique_lock<std::mutex>& lock, const std::string& processId, uint32_t virtualAddress);
     void createInitialBackingStoreEntry(const std::string& processId, uint32_t pageNumber);
     void removeBackingStoreEntry(const std::string& processId, uint32_t pageNumber);
-    void initializeProcessPages(const std::string& processId, size_t memorySize);
+    void touchFrame(ProcessMemoryInfo& info, uint32_t frameNumber);
+    void releasePins(ProcessMemoryInfo& info);
+    void initializeProcessPages(const std::string& processId, size_t memorySize, bool createBackingEntries = true);
     
 public:
-    MemoryManager(size_t maxMemory, size_t frameSize, size_t minMemPerProc, size_t maxMemPerProc);
+    MemoryManager(size_t maxMemory, size_t frameSize, size_t minMemPerProc, size_t maxMemPerProc,
+                  size_t backingStoreFiles = 1, const std::string& storePath = "csopesy-backing-store.txt",
+                  bool persistentStore = false, bool resumeStore = false);
     ~MemoryManager();
     
     bool allocateMemory(const std::string& processId, size_t requiredMemory);
     void deallocateMemory(const std::string& processId);
+    bool restoreMemory(const std::string& processId, size_t allocatedSize);
+    void checkpointPages();
     bool handlePageFault(const std::string& processId, uint32_t virtualAddress);
     uint16_t readMemory(const std::string& processId, uint32_t address);
     bool writeMemory(const std::string& processId, uint32_t address, uint16_t value);
     bool accessMemory(const std::string& processId, uint32_t address);
     
-    bool declareVariable(const std::string& processId, const std::string& varName, uint16_t value);
-    bool getVariable(const std::string& processId, const std::string& varName, uint16_t& value);
-    bool setVariable(const std::string& processId, const std::string& varName, uint16_t value);
+    void beginInstructionAccess(const std::string& processId);
+    void endInstructionAccess(const std::string& processId);
+    void setProcessRunning(const std::string& processId, bool running);
+    void setPreferIdleVictims(bool prefer) { preferIdleVictims = prefer; }
+    void setCommitLimit(size_t limit) { commitLimit = limit; }
+    
+    uint16_t readSymbol(const std::string& processId, int slot) { return readMemory(processId, slot * 2); }
+    bool writeSymbol(const std::string& processId, int slot, uint16_t value) { return writeMemory(processId, slot * 2, value); }
     
     void generateMemoryReport();
     void generateMemoryReport(const std::vector<std::shared_ptr<class Process>>& runningProcesses, int numCpu);
     void generateVmstatReport();
+    void generateTopReport(const std::string& sortKey);
     
     size_t getTotalMemory() const { return maxOverallMemory; }
     size_t getUsedMemory() const;
@@ -100,11 +135,13 @@ public:
     size_t getMinMemoryPerProcess() const { return minMemoryPerProcess; }
     size_t getMaxMemoryPerProcess() const { return maxMemoryPerProcess; }
     bool isValidMemorySize(size_t size) const;
+    bool canEverAllocate(size_t size) const;
     
     void incrementCpuTicks() { totalCpuTicks++; activeCpuTicks++; currentTime++; }
     void incrementIdleTicks() { totalCpuTicks++; idleCpuTicks++; currentTime++; }
     
     bool hasMemoryViolation(const std::string& processId) const;
+    bool getProcessMemoryStats(const std::string& processId, ProcessMemoryStats& stats);
     std::string getViolationInfo(const std::string& processId) const;
     
     size_t getProcessCount() const { return processMemoryMap.size(); }
@@ -112,6 +149,9 @@ public:
     size_t getPageFaults() const { return pageFaults; }
     size_t getPagesPagedIn() const { return pagesPagedIn; }
     size_t getPagesPagedOut() const { return pagesPagedOut; }
+    size_t getPinnedFrameCount() const;
+    size_t getEvictedWhileRunning() const { return evictedWhileRunning; }
+    size_t getBackingStoreFiles() const { return backingStore->getStripeCount(); }
 };
 
 #endif
@@ -0,0 +1,309 @@
+#include "instruction.h"
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+InstructionCompiler::InstructionCompiler(std::vector<std::string>& symbolNames, int symbolCapacity,
+                                         StringTable& strings, std::vector<std::string>& sourceLines)
+    : symbolNames(symbolNames), symbolCapacity(symbolCapacity), strings(strings), sourceLines(sourceLines) {
+}
+
+void InstructionCompiler::compile(const std::string& text, std::vector<Instruction>& program) {
+    compileStatement(text, program, 0);
+}
+
+void InstructionCompiler::compileStatement(const std::string& text, std::vector<Instruction>& program, int depth) {
+    uint32_t source = static_cast<uint32_t>(sourceLines.size());
+    sourceLines.push_back(text);
+
+    size_t nameEnd = 0;
+    if (statementName(text, nameEnd) != "FOR") {
+        Instruction instruction = decode(text);
+        instruction.source = source;
+        program.push_back(instruction);
+        return;
+    }
+
+    std::vector<std::string> body;
+    std::string repeats;
+    Instruction loop;
+    if (!splitLoop(text.substr(nameEnd), body, repeats)) {
+        loop = invalid("Unknown instruction: " + text);
+    } else if (depth >= maxLoopDepth) {
+        loop = invalid("FOR nested deeper than " + std::to_string(maxLoopDepth) + " levels");
+    } else {
+        loop.opcode = Opcode::FOR;
+        loop.left = resolveOperand(repeats, false);
+    }
+    loop.source = source;
+
+    size_t begin = program.size();
+    program.push_back(loop);
+    if (loop.opcode != Opcode::FOR) {
+        return;
+    }
+
+    for (const auto& statement : body) {
+        compileStatement(statement, program, depth + 1);
+    }
+
+    Instruction backEdge;
+    backEdge.opcode = Opcode::END_FOR;
+    backEdge.address = static_cast<uint32_t>(begin + 1);
+    backEdge.source = source;
+    program.push_back(backEdge);
+
+    program[begin].address = static_cast<uint32_t>(program.size());
+}
+
+std::string InstructionCompiler::statementName(const std::string& text, size_t& nameEnd) {
+    size_t start = text.find_first_not_of(" \t");
+    if (start == std::string::npos) {
+        nameEnd = text.length();
+        return "";
+    }
+
+    nameEnd = start;
+    while (nameEnd < text.length() && std::isalpha(static_cast<unsigned char>(text[nameEnd]))) {
+        nameEnd++;
+    }
+
+    std::string name = text.substr(start, nameEnd - start);
+    std::transform(name.begin(), name.end(), name.begin(), ::toupper);
+    return name;
+}
+
+// Splits "([stmt, stmt, ...], n)" or "[stmt; ...] n" into body statements and
+// the repeat count. Commas inside nested brackets, parentheses or quotes belong
+// to the inner statement.
+bool InstructionCompiler::splitLoop(const std::string& arguments, std::vector<std::string>& body, std::string& repeats) {
+    size_t open = arguments.find('[');
+    if (open == std::string::npos) {
+        return false;
+    }
+
+    int depth = 0;
+    bool quoted = false;
+    size_t close = std::string::npos;
+    std::string statement;
+
+    for (size_t i = open + 1; i < arguments.length(); ++i) {
+        char c = arguments[i];
+        if (c == '"') {
+            quoted = !quoted;
+        } else if (!quoted && (c == '[' || c == '(')) {
+            depth++;
+        } else if (!quoted && (c == ']' || c == ')')) {
+            if (depth == 0 && c == ']') {
+                close = i;
+                break;
+            }
+            depth--;
+        } else if (!quoted && depth == 0 && (c == ',' || c == ';')) {
+            size_t first = statement.find_first_not_of(" \t");
+            if (first != std::string::npos) {
+                body.push_back(statement.substr(first, statement.find_last_not_of(" \t") - first + 1));
+            }
+            statement.clear();
+            continue;
+        }
+        statement += c;
+    }
+
+    if (close == std::string::npos) {
+        return false;
+    }
+
+    size_t first = statement.find_first_not_of(" \t");
+    if (first != std::string::npos) {
+        body.push_back(statement.substr(first, statement.find_last_not_of(" \t") - first + 1));
+    }
+
+    repeats.clear();
+    for (size_t i = close + 1; i < arguments.length(); ++i) {
+        if (std::isdigit(static_cast<unsigned char>(arguments[i]))) {
+            repeats += arguments[i];
+        } else if (!repeats.empty() || std::isalpha(static_cast<unsigned char>(arguments[i]))) {
+            break;
+        }
+    }
+
+    return !repeats.empty();
+}
+
+Instruction InstructionCompiler::decode(const std::string& text) {
+    size_t nameEnd = 0;
+    std::string name = statementName(text, nameEnd);
+    if (name.empty()) {
+        return invalid("Unknown instruction: " + text);
+    }
+
+    std::string arguments = text.substr(nameEnd);
+    size_t argStart = arguments.find_first_not_of(" \t");
+    arguments = (argStart == std::string::npos) ? "" : arguments.substr(argStart);
+    if (!arguments.empty() && arguments.front() == '(') {
+        size_t close = arguments.rfind(')');
+        arguments = arguments.substr(1, (close == std::string::npos || close == 0) ? std::string::npos : close - 1);
+    }
+
+    Instruction instruction;
+
+    if (name == "DECLARE") {
+        auto args = splitArguments(arguments);
+        if (args.size() != 2) return invalid("Unknown instruction: " + text);
+        instruction.opcode = Opcode::DECLARE;
+        instruction.target = resolveSlot(args[0], true);
+        instruction.left = resolveOperand(args[1], false);
+        instruction.text = strings.add(args[0]);
+    } else if (name == "ADD" || name == "SUBTRACT") {
+        auto args = splitArguments(arguments);
+        if (args.size() != 3) return invalid("Unknown instruction: " + text);
+        instruction.opcode = (name == "ADD") ? Opcode::ADD : Opcode::SUBTRACT;
+        instruction.left = resolveOperand(args[1], true);
+        instruction.right = resolveOperand(args[2], true);
+        instruction.target = resolveSlot(args[0], true);
+        instruction.text = strings.add(args[0]);
+    } else if (name == "PRINT") {
+        std::string message = arguments;
+        std::string variable;
+        size_t plus = arguments.find(" + ");
+        if (plus != std::string::npos) {
+            message = arguments.substr(0, plus);
+            variable = arguments.substr(plus + 3);
+            variable.erase(std::remove_if(variable.begin(), variable.end(), ::isspace), variable.end());
+        }
+
+        if (message.length() >= 4 && message.compare(0, 2, "\\\"") == 0 &&
+            message.compare(message.length() - 2, 2, "\\\"") == 0) {
+            message = message.substr(2, message.length() - 4);
+        } else if (message.length() >= 2 && message.front() == '"' && message.back() == '"') {
+            message = message.substr(1, message.length() - 2);
+        }
+
+        instruction.opcode = Opcode::PRINT;
+        instruction.text = strings.add(message);
+        if (!variable.empty()) {
+            instruction.left = resolveOperand(variable, true);
+        }
+    } else if (name == "SLEEP") {
+        auto args = splitArguments(arguments);
+        if (args.size() != 1 || !std::isdigit(static_cast<unsigned char>(args[0][0]))) {
+            return invalid("Unknown instruction: " + text);
+        }
+        instruction.opcode = Opcode::SLEEP;
+        instruction.left = resolveOperand(args[0], false);
+    } else if (name == "READ") {
+        auto args = splitArguments(arguments);
+        if (args.empty()) return invalid("Invalid READ instruction format");
+
+        if (!parseAddress(args[0], instruction.address)) {
+            return invalid("Invalid memory address: " + args[0]);
+        }
+        instruction.opcode = Opcode::READ;
+    } else if (name == "WRITE") {
+        auto args = splitArguments(arguments);
+        if (args.size() < 2) return invalid("Invalid WRITE instruction format");
+
+        if (!parseAddress(args[0], instruction.address)) {
+            return invalid("Invalid WRITE parameters");
+        }
+        instruction.left = resolveOperand(args[1], false);
+        if (instruction.left.kind == OperandKind::NONE) {
+            return invalid("Invalid WRITE parameters");
+        }
+        instruction.opcode = Opcode::WRITE;
+    } else {
+        return invalid("Unknown instruction: " + text);
+    }
+
+    return instruction;
+}
+
+Instruction InstructionCompiler::invalid(const std::string& reason) {
+    Instruction instruction;
+    instruction.opcode = Opcode::INVALID;
+    instruction.text = strings.add(reason);
+    return instruction;
+}
+
+uint32_t StringTable::add(const std::string& value) {
+    auto found = index.find(value);
+    if (found != index.end()) return found->second;
+
+    uint32_t position = static_cast<uint32_t>(values.size());
+    values.push_back(value);
+    index.emplace(value, position);
+    return position;
+}
+
+Operand InstructionCompiler::resolveOperand(const std::string& token, bool create) {
+    Operand operand;
+    if (token.empty()) return operand;
+
+    if (std::isdigit(static_cast<unsigned char>(token[0]))) {
+        try {
+            unsigned long value = std::stoul(token);
+            operand.kind = OperandKind::IMMEDIATE;
+            operand.value = static_cast<uint16_t>(std::min<unsigned long>(value, UINT16_MAX));
+        } catch (const std::exception&) {
+            operand.kind = OperandKind::IMMEDIATE;
+            operand.value = UINT16_MAX;
+        }
+        return operand;
+    }
+
+    return resolveSlot(token, create);
+}
+
+// Slots are handed out in program order, matching the order in which the
+// interpreter would first have touched each variable.
+Operand InstructionCompiler::resolveSlot(const std::string& name, bool create) {
+    Operand operand;
+
+    for (size_t slot = 0; slot < symbolNames.size(); ++slot) {
+        if (symbolNames[slot] == name) {
+            operand.kind = OperandKind::SLOT;
+            operand.value = static_cast<uint16_t>(slot);
+            return operand;
+        }
+    }
+
+    if (create && static_cast<int>(symbolNames.size()) < symbolCapacity) {
+        symbolNames.push_back(name);
+        operand.kind = OperandKind::SLOT;
+        operand.value = static_cast<uint16_t>(symbolNames.size() - 1);
+    }
+
+    return operand;
+}
+
+bool InstructionCompiler::parseAddress(const std::string& token, uint32_t& address) {
+    try {
+        size_t used = 0;
+        address = static_cast<uint32_t>(std::stoul(token, &used, 16));
+        return used == token.length();
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+std::vector<std::string> InstructionCompiler::splitArguments(const std::string& arguments) {
+    std::vector<std::string> tokens;
+    std::string token;
+
+    for (char c : arguments) {
+        if (c == ',' || c == ' ' || c == '\t') {
+            if (!token.empty()) {
+                tokens.push_back(token);
+                token.clear();
+            }
+        } else {
+            token += c;
+        }
+    }
+    if (!token.empty()) {
+        tokens.push_back(token);
+    }
+
+    return tokens;
+}
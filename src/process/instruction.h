@@ -0,0 +1,94 @@
+#ifndef INSTRUCTION_H
+#define INSTRUCTION_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+enum class Opcode : uint8_t {
+    DECLARE,
+    ADD,
+    SUBTRACT,
+    PRINT,
+    SLEEP,
+    FOR,
+    END_FOR,
+    READ,
+    WRITE,
+    INCREMENT,
+    DECLARE_ADD,
+    INVALID
+};
+
+enum class OperandKind : uint8_t {
+    NONE,
+    SLOT,
+    IMMEDIATE
+};
+
+struct Operand {
+    OperandKind kind = OperandKind::NONE;
+    uint16_t value = 0;
+};
+
+// One decoded instruction. Variable names are already resolved to symbol table
+// slots and literals to immediates; `text` indexes the process string table
+// (message, variable name or decode error) and `source` the original
+// line for logs. For FOR and END_FOR, `address` is a jump target: the
+// instruction after the loop for FOR, the first body instruction for END_FOR.
+struct Instruction {
+    Opcode opcode = Opcode::INVALID;
+    Operand target;
+    Operand left;
+    Operand right;
+    uint32_t address = 0;
+    uint32_t text = 0;
+    uint32_t source = 0;
+};
+
+// A process's interned strings. The map finds an existing entry in O(1), so
+// compiling stays linear however many PRINT literals a streamed program adds.
+struct StringTable {
+    std::vector<std::string> values;
+    std::unordered_map<std::string, uint32_t> index;
+
+    uint32_t add(const std::string& value);
+    size_t size() const { return values.size(); }
+    const std::string& operator[](size_t i) const { return values[i]; }
+    void clear() { values.clear(); index.clear(); }
+};
+
+// Turns instruction text into Instructions. Both the call form used by the
+// generator ("ADD(x, y, 1)") and the space separated form accepted by
+// screen -c ("ADD x y 1") are understood. A FOR statement compiles to its body
+// placed between a FOR and an END_FOR back-edge, nested at most maxLoopDepth
+// levels deep.
+class InstructionCompiler {
+public:
+    static constexpr int maxLoopDepth = 3;
+
+    InstructionCompiler(std::vector<std::string>& symbolNames, int symbolCapacity,
+                        StringTable& strings, std::vector<std::string>& sourceLines);
+
+    void compile(const std::string& text, std::vector<Instruction>& program);
+    Instruction decode(const std::string& text);
+
+private:
+    std::vector<std::string>& symbolNames;
+    int symbolCapacity;
+    StringTable& strings;
+    std::vector<std::string>& sourceLines;
+
+    void compileStatement(const std::string& text, std::vector<Instruction>& program, int depth);
+    bool splitLoop(const std::string& arguments, std::vector<std::string>& body, std::string& repeats);
+    std::string statementName(const std::string& text, size_t& nameEnd);
+
+    Instruction invalid(const std::string& reason);
+    Operand resolveOperand(const std::string& token, bool create);
+    Operand resolveSlot(const std::string& name, bool create);
+    bool parseAddress(const std::string& token, uint32_t& address);
+    std::vector<std::string> splitArguments(const std::string& arguments);
+};
+
+#endif
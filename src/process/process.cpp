@@ -1,25 +1,25 @@
 #include "process.h"
 #include "../utils/utils.h"
 #include "../memory/memory_manager.h"
+#include "../utils/random.h"
+#include "../utils/clock.h"
 #include <chrono>
-#include <random>
 #include <sstream>
 #include <algorithm>
-#include <set>
 #include <climits>
 #include <iostream>
 #include <iomanip>
+#include <istream>
+#include <ostream>
 
 Process::Process(const std::string& processName) 
     : name(processName), state(ProcessState::NEW), priority(0), 
       coreAssignment(-1),
       executedInstructions(0), totalInstructions(0) {
     
-    static std::atomic<int> pidCounter{1};
-    pid = "p" + std::string(3 - std::to_string(pidCounter.load()).length(), '0') + 
-          std::to_string(pidCounter.fetch_add(1));
+    pid = nextPid();
     
-    creationTimestamp = Utils::getCurrentTimestamp();
+    creationTimestamp = Clock::now();
     arrivalTime = std::chrono::duration_cast<std::chrono::milliseconds>(
         std::chrono::high_resolution_clock::now().time_since_epoch()).count();
 }
@@ -29,11 +29,9 @@ Process::Process(const std::string& processName, size_t memorySize)
       coreAssignment(-1),
       executedInstructions(0), totalInstructions(0), allocatedMemory(memorySize) {
     
-    static std::atomic<int> pidCounter{1};
-    pid = "p" + std::string(3 - std::to_string(pidCounter.load()).length(), '0') + 
-          std::to_string(pidCounter.fetch_add(1));
+    pid = nextPid();
     
-    creationTimestamp = Utils::getCurrentTimestamp();
+    creationTimestamp = Clock::now();
     arrivalTime = std::chrono::duration_cast<std::chrono::milliseconds>(
         std::chrono::high_resolution_clock::now().time_since_epoch()).count();
 }
@@ -43,459 +41,787 @@ Process::Process(const std::string& processName, size_t memorySize, const std::v
       coreAssignment(-1),
       executedInstructions(0), totalInstructions(0), allocatedMemory(memorySize) {
     
-    static std::atomic<int> pidCounter{1};
-    pid = "p" + std::string(3 - std::to_string(pidCounter.load()).length(), '0') + 
-          std::to_string(pidCounter.fetch_add(1));
+    pid = nextPid();
     
-    creationTimestamp = Utils::getCurrentTimestamp();
+    creationTimestamp = Clock::now();
     arrivalTime = std::chrono::duration_cast<std::chrono::milliseconds>(
         std::chrono::high_resolution_clock::now().time_since_epoch()).count();
     
     setCustomInstructions(customInstructions);
 }
 
-void Process::generateInstructions(int count) {
+Process::Process(RestoreTag, const std::string& processName, const std::string& processId, size_t memorySize)
+    : pid(processId), name(processName), state(ProcessState::NEW), priority(0),
+      coreAssignment(-1),
+      executedInstructions(0), totalInstructions(0), allocatedMemory(memorySize) {
+    
+    creationTimestamp = Clock::now();
+}
+
+namespace {
+    std::atomic<int> pidCounter{1};
+}
+
+std::string Process::nextPid() {
+    std::string number = std::to_string(pidCounter.fetch_add(1));
+    if (number.length() < 3) {
+        number = std::string(3 - number.length(), '0') + number;
+    }
+    return "p" + number;
+}
+
+void Process::reservePid(const std::string& existingPid) {
+    if (existingPid.length() < 2) return;
+    
+    try {
+        int number = std::stoi(existingPid.substr(1));
+        int current = pidCounter.load();
+        while (current <= number && !pidCounter.compare_exchange_weak(current, number + 1)) {
+        }
+    } catch (const std::exception&) {
+    }
+}
+
+void Process::generateInstructions(int count, bool streaming) {
     totalInstructions = count;
     remainingTime = count;
     burstTime = count;
     
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    
-    std::vector<std::string> varNames = {"x", "y", "z", "counter", "sum", "temp", "result", "value"};
-    
-    std::uniform_int_distribution<> varDist(0, varNames.size() - 1);
-    std::uniform_int_distribution<> valueDist(1, 100);
-    std::uniform_int_distribution<> sleepDist(1, 5);
-    std::uniform_int_distribution<> forRepeatsDist(2, 5);
-    
-    std::vector<std::pair<std::string, int>> instructionWeights = {
-        {"DECLARE", 15},   
-        {"ADD", 20},       
-        {"SUBTRACT", 15},    
-        {"PRINT", 20},     
-        {"SLEEP", 10},      
-        {"FOR", 10},
-        {"READ", 15},     
-        {"WRITE", 15}      
+    generatorSeed = Utils::deriveSeed("process-" + pid);
+    streamingProgram = streaming;
+    generator.seed(generatorSeed);
+    linesGenerated = 0;
+    declaredVars = 0;
+    program.clear();
+    sourceLines.clear();
+    strings.clear();
+    log.clear();
+    logHead = 0;
+    programCounter = 0;
+    loopDepth = 0;
+    
+    if (!streaming) {
+        while (linesGenerated < totalInstructions) {
+            appendInstruction(generateLine());
+        }
+    }
+}
+
+namespace {
+    const char* const generatorVarNames[] = {"x", "y", "z", "counter", "sum", "temp", "result", "value"};
+    const int generatorVarCount = 8;
+    
+    enum class GeneratedKind { DECLARE, ADD, SUBTRACT, PRINT, SLEEP, FOR, READ, WRITE };
+    
+    const std::pair<GeneratedKind, int> generatorWeights[] = {
+        {GeneratedKind::DECLARE, 15},
+        {GeneratedKind::ADD, 20},
+        {GeneratedKind::SUBTRACT, 15},
+        {GeneratedKind::PRINT, 20},
+        {GeneratedKind::SLEEP, 10},
+        {GeneratedKind::FOR, 10},
+        {GeneratedKind::READ, 15},
+        {GeneratedKind::WRITE, 15}
     };
     
-    std::vector<std::string> weightedInstructions;
-    for (const auto& pair : instructionWeights) {
-        for (int i = 0; i < pair.second; ++i) {
-            weightedInstructions.push_back(pair.first);
+    GeneratedKind pickKind(Xoshiro256& rng) {
+        int total = 0;
+        for (const auto& weight : generatorWeights) total += weight.second;
+        
+        int pick = rng.range(0, total - 1);
+        for (const auto& weight : generatorWeights) {
+            if (pick < weight.second) return weight.first;
+            pick -= weight.second;
         }
+        return GeneratedKind::ADD;
     }
-    std::uniform_int_distribution<> instDist(0, weightedInstructions.size() - 1);
+}
+
+// Produces the next line of a generated program from the process's generator
+// state, so a queued process only carries a seed and a few counters until a
+// core starts fetching its instructions.
+std::string Process::generateLine() {
+    auto pickVar = [this]() { return std::string(generatorVarNames[generator.range(0, generatorVarCount - 1)]); };
+    auto declare = [this](const std::string& var) {
+        for (int i = 0; i < generatorVarCount; ++i) {
+            if (var == generatorVarNames[i]) declaredVars |= static_cast<uint8_t>(1u << i);
+        }
+    };
+    auto randomAddress = [this]() {
+        uint32_t address = generator.range(0, std::max(64, static_cast<int>(allocatedMemory) - 2));
+        return (address / 2) * 2;
+    };
     
-    std::set<std::string> declaredVars;
-    int currentNestingLevel = 0; 
+    std::string instruction;
     
-    for (int i = 0; i < count; ++i) {
-        std::string instructionType = weightedInstructions[instDist(gen)];
-        std::string instruction;
-        
-        if (instructionType == "DECLARE") {
-            std::string var = varNames[varDist(gen)];
-            int value = valueDist(gen);
-            instruction = "DECLARE(" + var + ", " + std::to_string(value) + ")";
-            declaredVars.insert(var);
-            
-        } else if (instructionType == "ADD") {
-            std::string var1 = varNames[varDist(gen)];
-            std::string var2 = varNames[varDist(gen)];
-            
-            if (gen() % 2 == 0) {
-                int value = valueDist(gen);
-                instruction = "ADD(" + var1 + ", " + var2 + ", " + std::to_string(value) + ")";
-            } else {
-                std::string var3 = varNames[varDist(gen)];
-                instruction = "ADD(" + var1 + ", " + var2 + ", " + var3 + ")";
-            }
-            declaredVars.insert(var1);
-            
-        } else if (instructionType == "SUBTRACT") {
-            std::string var1 = varNames[varDist(gen)];
-            std::string var2 = varNames[varDist(gen)];
-            
-            if (gen() % 2 == 0) {
-                int value = valueDist(gen);
-                instruction = "SUBTRACT(" + var1 + ", " + var2 + ", " + std::to_string(value) + ")";
-            } else {
-                std::string var3 = varNames[varDist(gen)];
-                instruction = "SUBTRACT(" + var1 + ", " + var2 + ", " + var3 + ")";
+    GeneratedKind kind = pickKind(generator);
+    switch (kind) {
+        case GeneratedKind::DECLARE: {
+            std::string var = pickVar();
+            instruction = "DECLARE(" + var + ", " + std::to_string(generator.range(1, 100)) + ")";
+            declare(var);
+            break;
+        }
+        case GeneratedKind::ADD:
+        case GeneratedKind::SUBTRACT: {
+            std::string var1 = pickVar();
+            std::string var2 = pickVar();
+            std::string operand = generator.next() % 2 == 0 ? std::to_string(generator.range(1, 100)) : pickVar();
+            instruction = std::string(kind == GeneratedKind::ADD ? "ADD(" : "SUBTRACT(") +
+                          var1 + ", " + var2 + ", " + operand + ")";
+            declare(var1);
+            break;
+        }
+        case GeneratedKind::PRINT: {
+            int declaredCount = 0;
+            for (int i = 0; i < generatorVarCount; ++i) {
+                if (declaredVars & (1u << i)) declaredCount++;
             }
-            declaredVars.insert(var1);
             
-        } else if (instructionType == "PRINT") {
-            if (!declaredVars.empty() && gen() % 3 == 0) {
-                auto it = declaredVars.begin();
-                std::advance(it, gen() % declaredVars.size());
-                std::string var = *it;
+            if (declaredCount > 0 && generator.next() % 3 == 0) {
+                int pick = static_cast<int>(generator.next() % declaredCount);
+                std::string var;
+                for (int i = 0; i < generatorVarCount; ++i) {
+                    if ((declaredVars & (1u << i)) && pick-- == 0) var = generatorVarNames[i];
+                }
                 instruction = "PRINT(\"Hello world from " + name + "!\" + " + var + ")";
             } else {
                 instruction = "PRINT(\"Hello world from " + name + "!\")";
             }
-            
-        } else if (instructionType == "SLEEP") {
-            int ticks = sleepDist(gen);
-            instruction = "SLEEP(" + std::to_string(ticks) + ")";
-            
-        } else if (instructionType == "READ") {
-            std::uniform_int_distribution<> addrDist(0, std::max(64, static_cast<int>(allocatedMemory - 2)));
-            uint32_t address = addrDist(gen);
-            address = (address / 2) * 2;
-            
+            break;
+        }
+        case GeneratedKind::SLEEP:
+            instruction = "SLEEP(" + std::to_string(generator.range(1, 5)) + ")";
+            break;
+        case GeneratedKind::READ: {
             std::ostringstream oss;
-            oss << "READ 0x" << std::hex << std::uppercase << address;
+            oss << "READ 0x" << std::hex << std::uppercase << randomAddress();
             instruction = oss.str();
-            
-        } else if (instructionType == "WRITE") {
-            std::uniform_int_distribution<> addrDist(0, std::max(64, static_cast<int>(allocatedMemory - 2)));
-            uint32_t address = addrDist(gen);
-            address = (address / 2) * 2;
-            
-            uint16_t value = static_cast<uint16_t>(valueDist(gen));
-            
+            break;
+        }
+        case GeneratedKind::WRITE: {
+            uint32_t address = randomAddress();
             std::ostringstream oss;
-            oss << "WRITE 0x" << std::hex << std::uppercase << address << " " << std::dec << value;
+            oss << "WRITE 0x" << std::hex << std::uppercase << address << " " << std::dec << generator.range(1, 100);
             instruction = oss.str();
+            break;
+        }
+        case GeneratedKind::FOR: {
+            int repeats = generator.range(2, 5);
+            int innerInstructions = std::min(2, totalInstructions - linesGenerated - 1);
+            bool nestedUsed = false;
             
-        } else if (instructionType == "FOR") {
-            if (currentNestingLevel < 3) {
-                currentNestingLevel++;
-                
-                int repeats = forRepeatsDist(gen);
-                int innerInstructions = std::min(2, count - i - 1);
-                
-                std::vector<std::string> forBody;
-                for (int j = 0; j < innerInstructions; ++j) {
-                    std::string innerType = weightedInstructions[instDist(gen)];
-                    
-                    if (innerType == "FOR" && currentNestingLevel >= 3) {
-                        innerType = "ADD"; 
-                    }
-                    
-                    std::string innerInstruction;
-                    if (innerType == "ADD") {
-                        std::string var = "counter";
-                        innerInstruction = "ADD(" + var + ", " + var + ", 1)";
-                    } else if (innerType == "PRINT") {
-                        innerInstruction = "PRINT(\"Hello world from " + name + "!\")";
-                    } else if (innerType == "DECLARE") {
-                        std::string var = varNames[varDist(gen)];
-                        int value = valueDist(gen);
-                        innerInstruction = "DECLARE(" + var + ", " + std::to_string(value) + ")";
-                    } else if (innerType == "FOR" && currentNestingLevel < 3) {
-                        innerInstruction = "FOR([ADD(counter, counter, 1)], 2)";
-                        currentNestingLevel++; 
-                    } else {
-                        innerInstruction = "ADD(counter, counter, 1)";
-                    }
-                    forBody.push_back(innerInstruction);
-                }
+            instruction = "FOR([";
+            for (int j = 0; j < innerInstructions; ++j) {
+                GeneratedKind innerKind = pickKind(generator);
+                std::string innerInstruction;
                 
-                instruction = "FOR([";
-                for (size_t k = 0; k < forBody.size(); ++k) {
-                    instruction += forBody[k];
-                    if (k < forBody.size() - 1) instruction += ", ";
+                if (innerKind == GeneratedKind::PRINT) {
+                    innerInstruction = "PRINT(\"Hello world from " + name + "!\")";
+                } else if (innerKind == GeneratedKind::DECLARE) {
+                    std::string var = pickVar();
+                    innerInstruction = "DECLARE(" + var + ", " + std::to_string(generator.range(1, 100)) + ")";
+                } else if (innerKind == GeneratedKind::FOR && !nestedUsed) {
+                    innerInstruction = "FOR([ADD(counter, counter, 1)], 2)";
+                    nestedUsed = true;
+                } else {
+                    innerInstruction = "ADD(counter, counter, 1)";
                 }
-                instruction += "], " + std::to_string(repeats) + ")";
                 
-                currentNestingLevel--;
-            } else {
-                std::string var1 = varNames[varDist(gen)];
-                std::string var2 = varNames[varDist(gen)];
-                int value = valueDist(gen);
-                instruction = "ADD(" + var1 + ", " + var2 + ", " + std::to_string(value) + ")";
-                declaredVars.insert(var1);
+                if (j > 0) instruction += ", ";
+                instruction += innerInstruction;
             }
+            instruction += "], " + std::to_string(repeats) + ")";
+            break;
         }
-        
-        pendingInstructions.push(instruction);
     }
+    
+    linesGenerated++;
+    return instruction;
+}
+
+bool Process::executeNextInstruction() {
+    return executeNextInstruction(nullptr);
+}
+
+bool Process::executeNextInstruction(MemoryManager* memoryManager) {
+    return executeInstructions(memoryManager, 1) > 0;
 }
 
-std::string Process::executeNextInstruction() {
-    if (pendingInstructions.empty()) {
-        return "";
+// Runs up to maxSteps instructions in one interpreter call, so superinstructions
+// can take their fused path, and returns how many ran. Synthetic accesses are
+// generated per instruction, so with an access pattern set the instructions
+// are still run one at a time.
+int Process::executeInstructions(MemoryManager* memoryManager, int maxSteps) {
+    if (!fetchReady()) {
+        return 0;
     }
     
-    std::string instruction = pendingInstructions.front();
-    pendingInstructions.pop();
-    
-    std::string timestamp = Utils::getCurrentTimestamp();
-    std::string result = processInstruction(instruction);
-    std::string logEntry = "(" + timestamp + ") Core:" + std::to_string(coreAssignment) + " " + instruction;
+    memory = memoryManager;
+    if (memoryManager) {
+        memoryManager->beginInstructionAccess(pid);
+    }
     
-    if (!result.empty()) {
-        logEntry += " -> " + result;
+    int steps = 0;
+    if (memoryManager && getAccessPattern() != AccessPattern::NONE) {
+        while (steps < maxSteps && fetchReady()) {
+            generateSyntheticAccesses(memoryManager);
+            int ran = run(1);
+            if (ran == 0) {
+                break;
+            }
+            steps += ran;
+        }
+    } else {
+        steps = run(maxSteps);
     }
     
-    instructionHistory.push_back(logEntry);
-    executedInstructions++;
-    remainingTime--;
+    if (memoryManager) {
+        memoryManager->endInstructionAccess(pid);
+    }
     
-    if (responseTime == -1) {
-        responseTime = std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::high_resolution_clock::now().time_since_epoch()).count() - arrivalTime;
+    return steps;
+}
+
+#if defined(__GNUC__) && !defined(CSOPESY_SWITCH_DISPATCH)
+#define CSOPESY_THREADED_DISPATCH
+#endif
+
+namespace {
+#ifdef CSOPESY_THREADED_DISPATCH
+    std::atomic<DispatchMode> dispatchMode{DispatchMode::THREADED};
+#else
+    std::atomic<DispatchMode> dispatchMode{DispatchMode::SWITCH};
+#endif
+    std::atomic<size_t> logDepth{100};
+    std::atomic<AccessPattern> accessPattern{AccessPattern::NONE};
+    
+    uint64_t mixAddress(uint64_t value) {
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+        return value ^ (value >> 31);
+    }
+}
+
+bool Process::threadedDispatchAvailable() {
+#ifdef CSOPESY_THREADED_DISPATCH
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Process::setDispatchMode(DispatchMode mode) {
+    if (mode == DispatchMode::THREADED && !threadedDispatchAvailable()) {
+        mode = DispatchMode::SWITCH;
+    }
+    dispatchMode.store(mode);
+}
+
+DispatchMode Process::getDispatchMode() {
+    return dispatchMode.load();
+}
+
+// Executes up to maxSteps instructions, stopping early when the process goes
+// to sleep, terminates or runs out of program. A step is one instruction plus
+// any END_FOR back-edges that immediately follow it. Returns the steps taken.
+int Process::run(int maxSteps, bool record) {
+    if (dispatchMode.load(std::memory_order_relaxed) == DispatchMode::THREADED) {
+        return runThreaded(maxSteps, record);
+    }
+    return runSwitch(maxSteps, record);
+}
+
+int Process::runSwitch(int maxSteps, bool record) {
+    int steps = 0;
+    
+    while (steps < maxSteps && state != ProcessState::WAITING && state != ProcessState::TERMINATED && fetchReady()) {
+        const Instruction& instruction = program[programCounter++];
+        LogRecord entry;
+        execute(instruction, entry);
+        if (instruction.opcode != Opcode::END_FOR) {
+            finishStep(instruction, entry, record);
+            steps++;
+        }
     }
     
-    return logEntry;
+    return steps;
+}
+
+// Direct-threaded variant of runSwitch: every handler ends by jumping straight
+// to the next instruction's handler through a label table, instead of going
+// back to one shared switch. Needs the GCC/Clang labels-as-values extension;
+// building with CSOPESY_SWITCH_DISPATCH leaves only the switch interpreter.
+int Process::runThreaded(int maxSteps, bool record) {
+#ifdef CSOPESY_THREADED_DISPATCH
+    static const void* const handlers[] = {
+        &&op_declare, &&op_add, &&op_subtract, &&op_print, &&op_sleep, &&op_for,
+        &&op_end_for, &&op_read, &&op_write, &&op_increment, &&op_declare_add, &&op_invalid
+    };
+    static_assert(sizeof(handlers) / sizeof(handlers[0]) == static_cast<size_t>(Opcode::INVALID) + 1,
+                  "every opcode needs a threaded handler");
+    
+    int steps = 0;
+    const Instruction* instruction = nullptr;
+    LogRecord entry;
+    
+#define DISPATCH() \
+    do { \
+        if (steps >= maxSteps || state == ProcessState::WAITING || \
+            state == ProcessState::TERMINATED || !fetchReady()) { \
+            return steps; \
+        } \
+        instruction = &program[programCounter++]; \
+        entry = LogRecord(); \
+        goto *handlers[static_cast<size_t>(instruction->opcode)]; \
+    } while (0)
+    
+#define FINISH_STEP() \
+    do { \
+        finishStep(*instruction, entry, record); \
+        steps++; \
+    } while (0)
+    
+    DISPATCH();
+    
+op_declare:
+    processDeclare(*instruction, entry);
+    FINISH_STEP();
+    DISPATCH();
+op_add:
+    processAdd(*instruction, entry);
+    FINISH_STEP();
+    DISPATCH();
+op_subtract:
+    processSubtract(*instruction, entry);
+    FINISH_STEP();
+    DISPATCH();
+op_print:
+    processPrint(*instruction, entry);
+    FINISH_STEP();
+    DISPATCH();
+op_sleep:
+    processSleep(*instruction, entry);
+    FINISH_STEP();
+    DISPATCH();
+op_for:
+    processFor(*instruction, entry);
+    FINISH_STEP();
+    DISPATCH();
+op_end_for:
+    processEndFor(*instruction);
+    DISPATCH();
+op_read:
+    processRead(*instruction, entry);
+    FINISH_STEP();
+    DISPATCH();
+op_write:
+    processWrite(*instruction, entry);
+    FINISH_STEP();
+    DISPATCH();
+op_increment:
+    processIncrement(*instruction, entry);
+    FINISH_STEP();
+    DISPATCH();
+op_declare_add:
+    // The ADD that follows is run without going back through dispatch.
+    processDeclare(*instruction, entry);
+    FINISH_STEP();
+    if (steps >= maxSteps || state == ProcessState::TERMINATED) {
+        return steps;
+    }
+    // Fusion only pairs a DECLARE with an ADD in the same window, but fall
+    // back to dispatch rather than trust that if the program has moved on.
+    if (programCounter >= program.size()) {
+        DISPATCH();
+    }
+    instruction = &program[programCounter++];
+    entry = LogRecord();
+    if (instruction->opcode == Opcode::INCREMENT) {
+        goto op_increment;
+    }
+    if (instruction->opcode == Opcode::ADD) {
+        goto op_add;
+    }
+    goto *handlers[static_cast<size_t>(instruction->opcode)];
+op_invalid:
+    FINISH_STEP();
+    DISPATCH();
+    
+#undef DISPATCH
+#undef FINISH_STEP
+#else
+    return runSwitch(maxSteps, record);
+#endif
 }
 
-std::string Process::executeNextInstruction(MemoryManager* memoryManager) {
-    if (pendingInstructions.empty()) {
-        return "";
+void Process::finishStep(const Instruction& instruction, LogRecord& entry, bool record) {
+    while (programCounter < program.size() && program[programCounter].opcode == Opcode::END_FOR) {
+        processEndFor(program[programCounter++]);
     }
     
-    std::string instruction = pendingInstructions.front();
-    pendingInstructions.pop();
+    if (record) {
+        entry.timestamp = Clock::now();
+        entry.instruction = instruction;
+        entry.core = static_cast<int16_t>(coreAssignment);
+        appendLog(entry);
+    }
     
-    std::string timestamp = Utils::getCurrentTimestamp();
+    if (loopDepth == 0) {
+        executedInstructions++;
+        remainingTime--;
+    }
+}
+
+void Process::setAccessPattern(AccessPattern pattern) {
+    accessPattern.store(pattern);
+}
+
+AccessPattern Process::getAccessPattern() {
+    return accessPattern.load();
+}
+
+// Optional memory traffic on top of what the program itself reads and writes,
+// for putting load on the pager. Synthetic addresses stay clear of the symbol
+// table so the generated writes never change a variable.
+void Process::generateSyntheticAccesses(MemoryManager* memoryManager) {
+    AccessPattern pattern = accessPattern.load(std::memory_order_relaxed);
+    uint32_t reserved = symbolTableSlots * 2;
+    if (pattern == AccessPattern::NONE || allocatedMemory <= reserved) {
+        return;
+    }
     
-    if (memoryManager && allocatedMemory > 0) {
-        uint32_t simulatedAddress = (executedInstructions * 4) % allocatedMemory;
-        memoryManager->accessMemory(pid, simulatedAddress);
-        
-        if (executedInstructions % 3 == 0) {
-            uint32_t writeAddress = (executedInstructions * 8) % allocatedMemory;
-            memoryManager->writeMemory(pid, writeAddress, static_cast<uint16_t>(executedInstructions & 0xFFFF));
-        }
-        
-        if (executedInstructions % 5 == 0) {
-            uint32_t readAddress = (executedInstructions * 12) % allocatedMemory;
-            memoryManager->readMemory(pid, readAddress);
+    uint32_t step = static_cast<uint32_t>(executedInstructions);
+    uint32_t span = static_cast<uint32_t>(allocatedMemory) - reserved;
+    auto address = [&](uint32_t stride, uint64_t stream) -> uint32_t {
+        if (pattern == AccessPattern::RANDOM) {
+            return reserved + static_cast<uint32_t>(mixAddress(generatorSeed + stream * step + step) % span);
         }
+        return reserved + (step * stride) % span;
+    };
+    
+    memoryManager->accessMemory(pid, address(4, 1));
+    
+    if (step % 3 == 0) {
+        memoryManager->writeMemory(pid, address(8, 2), static_cast<uint16_t>(step & 0xFFFF));
     }
     
-    std::string result = processInstruction(instruction);
-    std::string logEntry = "(" + timestamp + ") Core:" + std::to_string(coreAssignment) + " " + instruction;
-    
-    if (!result.empty()) {
-        logEntry += " -> " + result;
-    }
-    
-    instructionHistory.push_back(logEntry);
-    executedInstructions++;
-    remainingTime--;
-    
-    if (responseTime == -1) {
-        responseTime = std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::high_resolution_clock::now().time_since_epoch()).count() - arrivalTime;
-    }
-    
-    return logEntry;
-}
-
-std::string Process::processInstruction(const std::string& instruction) {
-    std::string upperInst = instruction;
-    std::transform(upperInst.begin(), upperInst.end(), upperInst.begin(), ::toupper);
-    
-    if (upperInst.find("DECLARE(") == 0) {
-        return processDeclare(instruction);
-    } else if (upperInst.find("ADD(") == 0) {
-        return processAdd(instruction);
-    } else if (upperInst.find("SUBTRACT(") == 0) {
-        return processSubtract(instruction);
-    } else if (upperInst.find("PRINT(") == 0) {
-        return processPrint(instruction);
-    } else if (upperInst.find("SLEEP(") == 0) {
-        return processSleep(instruction);
-    } else if (upperInst.find("FOR(") == 0) {
-        return processFor(instruction);
-    } else if (upperInst.find("READ ") == 0 || upperInst.find("READ\t") == 0) {
-        return processRead(instruction);
-    } else if (upperInst.find("WRITE ") == 0 || upperInst.find("WRITE\t") == 0) {
-        return processWrite(instruction);
-    }
-    else if (upperInst.find("DECLARE ") == 0) {
-        std::string params = instruction.substr(8);
-        return processDeclare("DECLARE(" + params + ")");
-    } else if (upperInst.find("ADD ") == 0) {
-        std::string params = instruction.substr(4);
-        return processAdd("ADD(" + params + ")");
-    } else if (upperInst.find("SUBTRACT ") == 0) {
-        std::string params = instruction.substr(9);
-        return processSubtract("SUBTRACT(" + params + ")");
-    } else if (upperInst.find("PRINT ") == 0) {
-        std::string params = instruction.substr(6);
-        return processPrint("PRINT(" + params + ")");
-    } else if (upperInst.find("SLEEP ") == 0) {
-        std::string params = instruction.substr(6);
-        return processSleep("SLEEP(" + params + ")");
-    } else if (upperInst.find("FOR ") == 0) {
-        std::string params = instruction.substr(4);
-        return processFor("FOR(" + params + ")");
-    } else if (upperInst.find("READ ") == 0 || upperInst.find("READ\t") == 0) {
-        return processRead(instruction);
-    }
-    else if (upperInst.find("READ ") == 0 || upperInst.find("READ\t") == 0) {
-        return processRead(instruction);
-    } else if (upperInst.find("WRITE ") == 0 || upperInst.find("WRITE\t") == 0) {
-        return processWrite(instruction);
-    }
-    else if (upperInst.find("PRINT ") == 0) {
-        std::string params = instruction.substr(6);
-        return processPrint("PRINT(" + params + ")");
-    }
-
-    return "Unknown instruction: " + instruction;
-    return "Unknown instruction: " + instruction;
-}
-
-std::string Process::processDeclare(const std::string& instruction) {
-    size_t start = instruction.find('(') + 1;
-    size_t end = instruction.find(')', start);
-    std::string params = instruction.substr(start, end - start);
-    
-    size_t comma = params.find(',');
-    if (comma != std::string::npos) {
-        std::string varName = params.substr(0, comma);
-        std::string valueStr = params.substr(comma + 1);
-        
-        varName.erase(std::remove_if(varName.begin(), varName.end(), ::isspace), varName.end());
-        valueStr.erase(std::remove_if(valueStr.begin(), valueStr.end(), ::isspace), valueStr.end());
-        
-        int value = std::stoi(valueStr);
-        uint16_t clampedValue = static_cast<uint16_t>(std::max(0, std::min(value, static_cast<int>(UINT16_MAX))));
-        variables[varName] = clampedValue;
-        
-        return "Declared " + varName + " = " + std::to_string(clampedValue);
+    if (step % 5 == 0) {
+        memoryManager->readMemory(pid, address(12, 3));
     }
-    return "";
 }
 
-std::string Process::processAdd(const std::string& instruction) {
-    size_t start = instruction.find('(') + 1;
-    size_t end = instruction.find(')', start);
-    std::string params = instruction.substr(start, end - start);
+void Process::setLogDepth(size_t depth) {
+    logDepth.store(std::max<size_t>(depth, 1));
+}
+
+// The log is a ring of the most recent records; once it holds logDepth entries
+// each new record overwrites the oldest one.
+void Process::appendLog(const LogRecord& entry) {
+    std::lock_guard<std::mutex> lock(logMutex);
+    size_t depth = logDepth.load(std::memory_order_relaxed);
+    
+    if (log.size() < depth) {
+        if (log.capacity() < depth) {
+            log.reserve(depth);
+        }
+        log.push_back(entry);
+        return;
+    }
     
-    std::vector<std::string> tokens;
-    std::stringstream ss(params);
-    std::string token;
-    while (std::getline(ss, token, ',')) {
-        token.erase(std::remove_if(token.begin(), token.end(), ::isspace), token.end());
-        tokens.push_back(token);
+    log[logHead] = entry;
+    logHead = (logHead + 1) % log.size();
+}
+
+size_t Process::getLogSize() const {
+    std::lock_guard<std::mutex> lock(logMutex);
+    return log.size();
+}
+
+std::vector<std::string> Process::formatLog() const {
+    std::lock_guard<std::mutex> lock(logMutex);
+    std::vector<std::string> lines;
+    lines.reserve(log.size());
+    
+    for (size_t i = 0; i < log.size(); ++i) {
+        const LogRecord& entry = log[(logHead + i) % log.size()];
+        lines.push_back("(" + Clock::format(entry.timestamp) + ") Core:" + std::to_string(entry.core) + " " + describe(entry));
     }
     
-    if (tokens.size() == 3) {
-        std::string var1 = tokens[0];
-        uint16_t val2 = getVariableOrValue(tokens[1]);
-        uint16_t val3 = getVariableOrValue(tokens[2]);
-        
-        uint32_t result32 = static_cast<uint32_t>(val2) + static_cast<uint32_t>(val3);
-        uint16_t result = static_cast<uint16_t>(std::min(result32, static_cast<uint32_t>(UINT16_MAX)));
-        
-        variables[var1] = result;
-        
-        return var1 + " = " + std::to_string(val2) + " + " + std::to_string(val3) + " = " + std::to_string(result);
+    return lines;
+}
+
+std::string Process::operandText(const Operand& operand) const {
+    if (operand.kind == OperandKind::SLOT && operand.value < symbolNames.size()) {
+        return symbolNames[operand.value];
     }
-    return "";
+    return std::to_string(operand.kind == OperandKind::IMMEDIATE ? operand.value : 0);
 }
 
-std::string Process::processSubtract(const std::string& instruction) {
-    size_t start = instruction.find('(') + 1;
-    size_t end = instruction.find(')', start);
-    std::string params = instruction.substr(start, end - start);
-    
-    std::vector<std::string> tokens;
-    std::stringstream ss(params);
-    std::string token;
-    while (std::getline(ss, token, ',')) {
-        token.erase(std::remove_if(token.begin(), token.end(), ::isspace), token.end());
-        tokens.push_back(token);
+// Rebuilds the text of a log line from its record. Instructions are shown in
+// call form rather than as typed, because streamed source lines are dropped
+// once their window has run.
+std::string Process::describe(const LogRecord& entry) const {
+    const Instruction& instruction = entry.instruction;
+    std::string name = instruction.text < strings.size() ? strings[instruction.text] : "";
+    std::ostringstream address;
+    address << "0x" << std::uppercase << std::hex << instruction.address;
+    
+    switch (instruction.opcode) {
+        case Opcode::DECLARE:
+        case Opcode::DECLARE_ADD:
+            return "DECLARE(" + name + ", " + operandText(instruction.left) + ") -> " +
+                   (entry.fault ? "Symbol table full, " + name + " ignored"
+                                : "Declared " + name + " = " + std::to_string(entry.result));
+        case Opcode::ADD:
+        case Opcode::INCREMENT:
+        case Opcode::SUBTRACT: {
+            bool add = instruction.opcode != Opcode::SUBTRACT;
+            return std::string(add ? "ADD(" : "SUBTRACT(") + name + ", " + operandText(instruction.left) + ", " +
+                   operandText(instruction.right) + ") -> " + name + " = " + std::to_string(entry.left) +
+                   (add ? " + " : " - ") + std::to_string(entry.right) + " = " + std::to_string(entry.result);
+        }
+        case Opcode::PRINT:
+            if (instruction.left.kind != OperandKind::NONE) {
+                return "PRINT(\"" + name + "\" + " + operandText(instruction.left) + ") -> OUTPUT: " + name + std::to_string(entry.left);
+            }
+            return "PRINT(\"" + name + "\") -> OUTPUT: " + name;
+        case Opcode::SLEEP:
+            return "SLEEP(" + operandText(instruction.left) + ") -> Sleeping for " + std::to_string(entry.left) + " CPU ticks";
+        case Opcode::FOR:
+            return "FOR([...], " + operandText(instruction.left) + ") -> Executing FOR loop " + std::to_string(entry.left) + " times";
+        case Opcode::READ:
+            return "READ " + address.str() + " -> " +
+                   (entry.fault ? "Memory access violation at " + address.str()
+                                : "READ " + address.str() + " = " + std::to_string(entry.result));
+        case Opcode::WRITE:
+            return "WRITE " + address.str() + " " + operandText(instruction.left) + " -> " +
+                   (entry.fault ? "Memory access violation at " + address.str()
+                                : "WRITE " + std::to_string(entry.left) + " to " + address.str());
+        case Opcode::END_FOR:
+        case Opcode::INVALID:
+            break;
+    }
+    return "INVALID -> " + name;
+}
+
+Instruction Process::decodeInstruction(const std::string& text) {
+    InstructionCompiler compiler(symbolNames, symbolCapacity(), strings, sourceLines);
+    return compiler.decode(text);
+}
+
+// Instructions are decoded once, when they are added to the program, so the
+// interpreter only ever dispatches on an opcode and reads resolved operands.
+// A FOR statement counts as one line of progress however many times its body
+// runs; each body instruction still takes its own step.
+void Process::appendInstruction(const std::string& text) {
+    size_t first = program.empty() ? 0 : program.size() - 1;
+    InstructionCompiler compiler(symbolNames, symbolCapacity(), strings, sourceLines);
+    compiler.compile(text, program);
+    fuseSuperinstructions(first);
+}
+
+// Rewrites common generator patterns into superinstructions: x = x + constant
+// becomes INCREMENT, and a DECLARE directly followed by an ADD becomes
+// DECLARE_ADD so the threaded interpreter can run the pair with one dispatch.
+// Both instructions of a pair stay in the program, so program counters, logs
+// and checkpoints are unaffected.
+void Process::fuseSuperinstructions(size_t first) {
+    for (size_t i = first; i < program.size(); ++i) {
+        Instruction& instruction = program[i];
+        if (instruction.opcode == Opcode::ADD && instruction.target.kind == OperandKind::SLOT &&
+            instruction.left.kind == OperandKind::SLOT && instruction.left.value == instruction.target.value &&
+            instruction.right.kind == OperandKind::IMMEDIATE) {
+            instruction.opcode = Opcode::INCREMENT;
+        }
     }
     
-    if (tokens.size() == 3) {
-        std::string var1 = tokens[0];
-        uint16_t val2 = getVariableOrValue(tokens[1]);
-        uint16_t val3 = getVariableOrValue(tokens[2]);
-        
-        uint16_t result = (val2 > val3) ? (val2 - val3) : 0;
-        
-        variables[var1] = result;
-        
-        return var1 + " = " + std::to_string(val2) + " - " + std::to_string(val3) + " = " + std::to_string(result);
+    for (size_t i = first; i + 1 < program.size(); ++i) {
+        Opcode next = program[i + 1].opcode;
+        if (program[i].opcode == Opcode::DECLARE && (next == Opcode::ADD || next == Opcode::INCREMENT)) {
+            program[i].opcode = Opcode::DECLARE_ADD;
+        }
     }
-    return "";
 }
 
-std::string Process::processPrint(const std::string& instruction) {
-    size_t start = instruction.find('(') + 1;
-    size_t end = instruction.find(')', start);
-    std::string content = instruction.substr(start, end - start);
+void Process::restartProgram() {
+    programCounter = 0;
+    loopDepth = 0;
+    
+    if (streamingProgram) {
+        generator.seed(generatorSeed);
+        linesGenerated = 0;
+        declaredVars = 0;
+        program.clear();
+        sourceLines.clear();
+    }
+}
+
+// Makes sure the program counter points at an instruction, generating the next
+// few lines of a streamed program once the current window is used up. Windows
+// are only swapped between top-level lines, so no jump target ever refers to
+// an instruction that has been dropped.
+bool Process::fetchReady() {
+    if (programCounter < program.size()) {
+        return true;
+    }
+    if (!streamingProgram || linesGenerated >= totalInstructions || loopDepth != 0) {
+        return false;
+    }
     
-    if (content.find(" + ") != std::string::npos) {
-        size_t plusPos = content.find(" + ");
-        std::string msgPart = content.substr(0, plusPos);
-        std::string varPart = content.substr(plusPos + 3);
-        
-        if (msgPart.front() == '"' && msgPart.back() == '"') {
-            msgPart = msgPart.substr(1, msgPart.length() - 2);
-        }
-        
-        uint16_t varValue = getVariableOrValue(varPart);
-        return "OUTPUT: " + msgPart + std::to_string(varValue);
-    } else {
-        if (content.front() == '"' && content.back() == '"') {
-            content = content.substr(1, content.length() - 2);
-        }
-        return "OUTPUT: " + content;
+    program.clear();
+    sourceLines.clear();
+    programCounter = 0;
+    
+    std::lock_guard<std::mutex> lock(logMutex);
+    for (size_t line = 0; line < lookaheadLines && linesGenerated < totalInstructions; ++line) {
+        appendInstruction(generateLine());
+    }
+    return !program.empty();
+}
+
+bool Process::hasMoreInstructions() const {
+    return programCounter < program.size() || (streamingProgram && linesGenerated < totalInstructions);
+}
+
+// SJF/SRTF ready queue order, shared by the scheduler and the simulation:
+// fewest remaining instructions first, ties in arrival order.
+int64_t Process::shortestFirstKey() const {
+    return (static_cast<int64_t>(remainingTime) << 32) | static_cast<uint32_t>(arrivalTime);
+}
+
+void Process::execute(const Instruction& instruction, LogRecord& entry) {
+    switch (instruction.opcode) {
+        case Opcode::DECLARE: processDeclare(instruction, entry); break;
+        case Opcode::ADD: processAdd(instruction, entry); break;
+        case Opcode::SUBTRACT: processSubtract(instruction, entry); break;
+        case Opcode::PRINT: processPrint(instruction, entry); break;
+        case Opcode::SLEEP: processSleep(instruction, entry); break;
+        case Opcode::FOR: processFor(instruction, entry); break;
+        case Opcode::END_FOR: processEndFor(instruction); break;
+        case Opcode::READ: processRead(instruction, entry); break;
+        case Opcode::WRITE: processWrite(instruction, entry); break;
+        case Opcode::INCREMENT: processIncrement(instruction, entry); break;
+        case Opcode::DECLARE_ADD: processDeclare(instruction, entry); break;
+        case Opcode::INVALID: break;
+    }
+}
+
+void Process::processDeclare(const Instruction& instruction, LogRecord& entry) {
+    if (instruction.target.kind != OperandKind::SLOT) {
+        entry.fault = true;
+        return;
     }
+    
+    entry.result = operandValue(instruction.left);
+    storeSymbol(instruction.target.value, entry.result);
 }
 
-std::string Process::processSleep(const std::string& instruction) {
-    size_t start = instruction.find('(') + 1;
-    size_t end = instruction.find(')', start);
-    std::string ticksStr = instruction.substr(start, end - start);
+void Process::processAdd(const Instruction& instruction, LogRecord& entry) {
+    entry.left = operandValue(instruction.left);
+    entry.right = operandValue(instruction.right);
     
-    int ticks = std::stoi(ticksStr);
-    sleepRemaining = ticks;
-    state = ProcessState::WAITING;
-    return "Sleeping for " + std::to_string(ticks) + " CPU ticks";
+    uint32_t result32 = static_cast<uint32_t>(entry.left) + static_cast<uint32_t>(entry.right);
+    entry.result = static_cast<uint16_t>(std::min(result32, static_cast<uint32_t>(UINT16_MAX)));
+    
+    if (instruction.target.kind == OperandKind::SLOT) {
+        storeSymbol(instruction.target.value, entry.result);
+    }
 }
 
-std::string Process::processFor(const std::string& instruction) {
-    size_t repeatStart = instruction.rfind(',') + 1;
-    size_t repeatEnd = instruction.find(')', repeatStart);
-    std::string repeatsStr = instruction.substr(repeatStart, repeatEnd - repeatStart);
-    repeatsStr.erase(std::remove_if(repeatsStr.begin(), repeatsStr.end(), ::isspace), repeatsStr.end());
+void Process::processIncrement(const Instruction& instruction, LogRecord& entry) {
+    entry.left = loadSymbol(instruction.target.value);
+    entry.right = instruction.right.value;
+    entry.result = static_cast<uint16_t>(std::min<uint32_t>(entry.left + entry.right, UINT16_MAX));
+    storeSymbol(instruction.target.value, entry.result);
+}
+
+void Process::processSubtract(const Instruction& instruction, LogRecord& entry) {
+    entry.left = operandValue(instruction.left);
+    entry.right = operandValue(instruction.right);
+    entry.result = (entry.left > entry.right) ? (entry.left - entry.right) : 0;
     
-    int repeats = std::stoi(repeatsStr);
-    return "Executing FOR loop " + std::to_string(repeats) + " times";
+    if (instruction.target.kind == OperandKind::SLOT) {
+        storeSymbol(instruction.target.value, entry.result);
+    }
 }
 
-uint16_t Process::getVariableOrValue(const std::string& token) {
-    if (std::isdigit(token[0])) {
-        int value = std::stoi(token);
-        return static_cast<uint16_t>(std::max(0, std::min(value, static_cast<int>(UINT16_MAX))));
+void Process::processPrint(const Instruction& instruction, LogRecord& entry) {
+    if (instruction.left.kind != OperandKind::NONE) {
+        entry.left = operandValue(instruction.left);
+    }
+}
+
+void Process::processSleep(const Instruction& instruction, LogRecord& entry) {
+    entry.left = operandValue(instruction.left);
+    sleepRemaining = entry.left;
+    if (sleepRemaining > 0) {
+        state = ProcessState::WAITING;
+    }
+}
+
+void Process::processFor(const Instruction& instruction, LogRecord& entry) {
+    entry.left = operandValue(instruction.left);
+    if (entry.left == 0) {
+        programCounter = instruction.address;
     } else {
-        if (variables.find(token) == variables.end()) {
-            variables[token] = 0;
-        }
-        return variables[token];
+        loopCounters[loopDepth++] = entry.left;
     }
 }
 
+void Process::processEndFor(const Instruction& instruction) {
+    if (--loopCounters[loopDepth - 1] > 0) {
+        programCounter = instruction.address;
+    } else {
+        loopDepth--;
+    }
+}
+
+uint16_t Process::operandValue(const Operand& operand) {
+    switch (operand.kind) {
+        case OperandKind::IMMEDIATE: return operand.value;
+        case OperandKind::SLOT: return loadSymbol(operand.value);
+        default: return 0;
+    }
+}
+
+int Process::symbolCapacity() const {
+    if (allocatedMemory == 0) return symbolTableSlots;
+    return static_cast<int>(std::min<size_t>(symbolTableSlots, allocatedMemory / 2));
+}
+
+// Symbol slots live in simulated memory when a memory manager is attached, so
+// every variable access goes through the pager like any other load or store.
+uint16_t Process::loadSymbol(int slot) {
+    if (memory) {
+        return memory->readSymbol(pid, slot);
+    }
+    return localSymbols[slot];
+}
+
+void Process::storeSymbol(int slot, uint16_t value) {
+    if (memory) {
+        memory->writeSymbol(pid, slot, value);
+        return;
+    }
+    localSymbols[slot] = value;
+}
+
 bool Process::isComplete() const {
-    return (pendingInstructions.empty() && executedInstructions >= totalInstructions) || 
+    return (!hasMoreInstructions() && executedInstructions >= totalInstructions) || 
            (state == ProcessState::TERMINATED);
 }
 
+// Wall-clock milliseconds. The scheduler adds to waitingTime and sets
+// responseTime when it dispatches the process.
 void Process::updateMetrics() {
-    int currentTime = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::high_resolution_clock::now().time_since_epoch()).count();
-    
     if (state == ProcessState::TERMINATED) {
-        turnaroundTime = currentTime - arrivalTime;
-        waitingTime = turnaroundTime - burstTime;
-        completionTimestamp = Utils::getCurrentTimestamp();
+        completionTimestamp = Clock::now();
+        turnaroundTime = static_cast<int>(completionTimestamp - creationTimestamp);
     }
 }
 
 Process::~Process() {
-    variables.clear();
 }
 
 std::string Process::getStateString() const {
@@ -518,12 +844,12 @@ void Process::setCustomInstructions(const std::vector<std::string>& instructions
     remainingTime = totalInstructions;
     burstTime = totalInstructions;
     
-    while (!pendingInstructions.empty()) {
-        pendingInstructions.pop();
-    }
+    program.clear();
+    sourceLines.clear();
+    restartProgram();
     
     for (const auto& instruction : instructions) {
-        pendingInstructions.push(instruction);
+        appendInstruction(instruction);
     }
 }
 
@@ -534,7 +860,7 @@ void Process::setMemoryAllocation(size_t memory) {
 void Process::handleMemoryViolation(uint32_t address) {
     memoryViolationOccurred = true;
     violationAddress = address;
-    violationTimestamp = Utils::getCurrentTimestamp();
+    violationTimestamp = Clock::now();
     state = ProcessState::TERMINATED;
 }
 
@@ -547,59 +873,144 @@ std::string Process::getViolationInfo() const {
     
     std::ostringstream oss;
     oss << "Process " << name << " shut down due to memory access violation error that occurred at " 
-        << violationTimestamp << ". 0x" << std::hex << violationAddress << " invalid.";
+        << Clock::format(violationTimestamp) << ". 0x" << std::hex << violationAddress << " invalid.";
     return oss.str();
 }
 
-std::string Process::processRead(const std::string& instruction) {
-    std::istringstream iss(instruction);
-    std::string command, hexAddr;
+// now is the scheduler's CPU tick; a parked sleeper saves only the ticks it
+// still has to wait.
+void Process::writeCheckpoint(std::ostream& out, uint64_t now) const {
+    int sleeping = sleepRemaining;
+    if (wakeTick != 0) {
+        sleeping = wakeTick > now ? static_cast<int>(wakeTick - now) : 0;
+    }
+    out << "PROCESS " << name << " " << pid << " " << allocatedMemory << " " << arrivalTime << " "
+        << executedInstructions << " " << totalInstructions << " " << sleeping << "\n";
+    out << "CREATED " << creationTimestamp << "\n";
+    out << "PRIORITY " << priority.load() << "\n";
     
-    if (!(iss >> command >> hexAddr)) {
-        return "Invalid READ instruction format";
+    for (const auto& symbol : symbolNames) {
+        out << "VAR " << symbol << "\n";
     }
     
-    try {
-        uint32_t address = std::stoul(hexAddr, nullptr, 16);
-        
-        if (address >= allocatedMemory) {
-            handleMemoryViolation(address);
-            return "Memory access violation at " + hexAddr;
+    int depth = 0;
+    for (const auto& instruction : program) {
+        if (depth == 0 && instruction.opcode != Opcode::END_FOR) {
+            out << "INSTR " << sourceLines[instruction.source] << "\n";
         }
-        
-        int value = 0;
-        
-        return "READ " + hexAddr + " = " + std::to_string(value);
-    } catch (const std::exception& e) {
-        return "Invalid memory address: " + hexAddr;
+        if (instruction.opcode == Opcode::FOR) depth++;
+        if (instruction.opcode == Opcode::END_FOR) depth--;
+    }
+    
+    if (streamingProgram) {
+        out << "GENERATOR " << generatorSeed << " " << linesGenerated << " " << static_cast<int>(declaredVars);
+        for (int word = 0; word < 4; ++word) {
+            out << " " << generator.getState(word);
+        }
+        out << "\n";
+    }
+    
+    out << "STATE " << programCounter << " " << loopDepth;
+    for (int level = 0; level < loopDepth; ++level) {
+        out << " " << loopCounters[level];
     }
+    out << "\n";
+    
+    out << "END_PROCESS\n";
 }
 
-std::string Process::processWrite(const std::string& instruction) {
-    std::istringstream iss(instruction);
-    std::string command, hexAddr, valueStr;
-    
-    if (!(iss >> command >> hexAddr >> valueStr)) {
-        return "Invalid WRITE instruction format";
+std::shared_ptr<Process> Process::readCheckpoint(std::istream& in) {
+    std::string line;
+    while (std::getline(in, line) && line.rfind("PROCESS ", 0) != 0) {
+    }
+    if (!in) return nullptr;
+    
+    std::istringstream header(line.substr(8));
+    std::string processName, processId;
+    size_t memory = 0;
+    int arrival = 0, executed = 0, total = 0, sleeping = 0;
+    if (!(header >> processName >> processId >> memory >> arrival >> executed >> total >> sleeping)) {
+        return nullptr;
     }
     
-    try {
-        uint32_t address = std::stoul(hexAddr, nullptr, 16);
-        uint16_t value;
-        
-        if (variables.find(valueStr) != variables.end()) {
-            value = variables[valueStr];
-        } else {
-            value = static_cast<uint16_t>(std::stoul(valueStr));
-        }
-        
-        if (address >= allocatedMemory) {
-            handleMemoryViolation(address);
-            return "Memory access violation at " + hexAddr;
+    std::shared_ptr<Process> process(new Process(RestoreTag{}, processName, processId, memory));
+    process->arrivalTime = arrival;
+    process->executedInstructions = executed;
+    process->totalInstructions = total;
+    process->burstTime = total;
+    process->remainingTime = total - executed;
+    process->sleepRemaining = sleeping;
+    reservePid(processId);
+    
+    while (std::getline(in, line) && line != "END_PROCESS") {
+        if (line.rfind("CREATED ", 0) == 0) {
+            std::istringstream created(line.substr(8));
+            int64_t timestamp = 0;
+            if (created >> timestamp && created.eof()) {
+                process->creationTimestamp = timestamp;
+            }
+        } else if (line.rfind("PRIORITY ", 0) == 0) {
+            std::istringstream level(line.substr(9));
+            int value = 0;
+            if (level >> value) {
+                process->priority = value;
+            }
+        } else if (line.rfind("VAR ", 0) == 0) {
+            std::istringstream var(line.substr(4));
+            std::string varName;
+            if (var >> varName) {
+                process->symbolNames.push_back(varName);
+            }
+        } else if (line.rfind("INSTR ", 0) == 0) {
+            process->appendInstruction(line.substr(6));
+        } else if (line.rfind("GENERATOR ", 0) == 0) {
+            std::istringstream generatorState(line.substr(10));
+            int declared = 0;
+            uint64_t word = 0;
+            generatorState >> process->generatorSeed >> process->linesGenerated >> declared;
+            process->declaredVars = static_cast<uint8_t>(declared);
+            for (int index = 0; index < 4 && generatorState >> word; ++index) {
+                process->generator.setState(index, word);
+            }
+            process->streamingProgram = true;
+        } else if (line.rfind("STATE ", 0) == 0) {
+            std::istringstream position(line.substr(6));
+            position >> process->programCounter >> process->loopDepth;
+            process->loopDepth = std::max(0, std::min(process->loopDepth, InstructionCompiler::maxLoopDepth));
+            for (int level = 0; level < process->loopDepth; ++level) {
+                position >> process->loopCounters[level];
+            }
         }
-        
-        return "WRITE " + std::to_string(value) + " to " + hexAddr;
-    } catch (const std::exception&) {
-        return "Invalid WRITE parameters";
+    }
+    
+    process->programCounter = std::min(process->programCounter, process->program.size());
+    process->state = ProcessState::READY;
+    return process;
+}
+
+// READ and WRITE go through the pager when a memory manager is attached, the
+// same way symbol table accesses do. Without one there is no backing memory
+// and a READ yields 0.
+void Process::processRead(const Instruction& instruction, LogRecord& entry) {
+    if (instruction.address >= allocatedMemory) {
+        handleMemoryViolation(instruction.address);
+        entry.fault = true;
+        return;
+    }
+    
+    entry.result = memory ? memory->readMemory(pid, instruction.address) : 0;
+}
+
+void Process::processWrite(const Instruction& instruction, LogRecord& entry) {
+    entry.left = operandValue(instruction.left);
+    
+    if (instruction.address >= allocatedMemory) {
+        handleMemoryViolation(instruction.address);
+        entry.fault = true;
+        return;
+    }
+    
+    if (memory) {
+        memory->writeMemory(pid, instruction.address, entry.left);
     }
 }
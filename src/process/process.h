@@ -6,6 +6,13 @@
 #include <queue>
 #include <map>
 #include <atomic>
+#include <mutex>
+#include <memory>
+#include <iosfwd>
+#include <array>
+#include <cstdint>
+#include "instruction.h"
+#include "../utils/random.h"
 
 enum class ProcessState {
     NEW,
@@ -15,42 +22,84 @@ enum class ProcessState {
     TERMINATED
 };
 
-class Process {
+enum class DispatchMode {
+    SWITCH,
+    THREADED
+};
+
+enum class AccessPattern {
+    NONE,
+    SEQUENTIAL,
+    RANDOM
+};
+
+// One executed instruction as it is kept in the process log. Only values are
+// stored; the text shown by process-smi and screen -r is built from the record
+// when a log is displayed.
+struct LogRecord {
+    int64_t timestamp = 0;
+    Instruction instruction;
+    int16_t core = -1;
+    bool fault = false;
+    uint16_t left = 0;
+    uint16_t right = 0;
+    uint16_t result = 0;
+};
+
+class Process : public std::enable_shared_from_this<Process> {
 public:
     std::string pid;
     std::string name;
     ProcessState state;
-    int priority;
+    std::atomic<int> priority;
     int arrivalTime;
     int burstTime;
     int remainingTime;
     int executedInstructions;
     int totalInstructions;
     int coreAssignment;
-    std::string creationTimestamp;
-    std::string completionTimestamp;
-    std::vector<std::string> instructionHistory;
-    std::queue<std::string> pendingInstructions;
+    int64_t creationTimestamp = 0;
+    int64_t completionTimestamp = 0;
+    std::vector<Instruction> program;
+    std::vector<std::string> sourceLines;
+    size_t programCounter = 0;
     
     int waitingTime = 0;
     int turnaroundTime = 0;
     int responseTime = -1;
+    int64_t readySince = 0;
+    
+    // The core the process last ran on and the scheduler tick it left it,
+    // kept while coreAssignment is -1 so dispatch can prefer a warm core.
+    int lastCore = -1;
+    uint64_t lastRanTick = 0;
+    int dispatches = 0;
+    int migrations = 0;
+    
+    // Under adaptive round robin: the process's own quantum before the global
+    // scale (0 until its first slice ends), and its major page faults so far.
+    int quantum = 0;
+    size_t majorFaultsSeen = 0;
     int sleepRemaining = 0;
+    // CPU tick at which the scheduler's timer wheel wakes the process, or 0
+    // while it is not parked there.
+    uint64_t wakeTick = 0;
     
     size_t allocatedMemory = 0;
     uint32_t baseAddress = 0;
     bool memoryViolationOccurred = false;
-    std::string violationTimestamp;
+    int64_t violationTimestamp = 0;
     uint32_t violationAddress = 0;
     
     Process(const std::string& processName);
     Process(const std::string& processName, size_t memorySize);
     Process(const std::string& processName, size_t memorySize, const std::vector<std::string>& customInstructions);
     
-    void generateInstructions(int count);
+    void generateInstructions(int count, bool streaming = true);
     void setCustomInstructions(const std::vector<std::string>& instructions);
-    std::string executeNextInstruction();
-    std::string executeNextInstruction(class MemoryManager* memoryManager);
+    bool executeNextInstruction();
+    bool executeNextInstruction(class MemoryManager* memoryManager);
+    int executeInstructions(class MemoryManager* memoryManager, int maxSteps);
     bool isComplete() const;
     void updateMetrics();
     std::string getStateString() const;
@@ -58,21 +107,82 @@ public:
     void handleMemoryViolation(uint32_t address);
     bool hasMemoryViolation() const;
     std::string getViolationInfo() const;
+    Instruction decodeInstruction(const std::string& text);
+    void execute(const Instruction& instruction, LogRecord& entry);
+    int run(int maxSteps, bool record = true);
+    void restartProgram();
+    bool fetchReady();
+    bool hasMoreInstructions() const;
+    int64_t shortestFirstKey() const;
+    static void setDispatchMode(DispatchMode mode);
+    static DispatchMode getDispatchMode();
+    static bool threadedDispatchAvailable();
+    std::vector<std::string> formatLog() const;
+    size_t getLogSize() const;
+    static void setLogDepth(size_t depth);
+    static void setAccessPattern(AccessPattern pattern);
+    static AccessPattern getAccessPattern();
+    void writeCheckpoint(std::ostream& out, uint64_t now) const;
+    static std::shared_ptr<Process> readCheckpoint(std::istream& in);
+    static void reservePid(const std::string& existingPid);
     ~Process();
 
+    // The symbol table is the first 64 bytes of page 0: 32 two-byte slots.
+    static constexpr int symbolTableSlots = 32;
+    // Generated lines compiled ahead of the one being executed.
+    static constexpr size_t lookaheadLines = 4;
+    
 private:
-    std::map<std::string, uint16_t> variables;
+    std::vector<std::string> symbolNames;
+    std::array<uint16_t, symbolTableSlots> localSymbols{};
+    class MemoryManager* memory = nullptr;
+    
+    StringTable strings;
+    std::array<uint16_t, InstructionCompiler::maxLoopDepth> loopCounters{};
+    int loopDepth = 0;
+    
+    std::vector<LogRecord> log;
+    size_t logHead = 0;
+    // Held while the log is written or formatted, and while a streamed window
+    // adds to the string and symbol tables that records refer to.
+    mutable std::mutex logMutex;
+    
+    bool streamingProgram = false;
+    uint64_t generatorSeed = 0;
+    Xoshiro256 generator;
+    int linesGenerated = 0;
+    uint8_t declaredVars = 0;
+    
+    int symbolCapacity() const;
+    uint16_t loadSymbol(int slot);
+    void storeSymbol(int slot, uint16_t value);
+    
+    // Used by readCheckpoint: keeps the saved pid instead of taking a new one.
+    struct RestoreTag {};
+    Process(RestoreTag, const std::string& processName, const std::string& processId, size_t memorySize);
     
-    std::string processInstruction(const std::string& instruction);
-    std::string processDeclare(const std::string& instruction);
-    std::string processAdd(const std::string& instruction);
-    std::string processSubtract(const std::string& instruction);
-    std::string processPrint(const std::string& instruction);
-    std::string processSleep(const std::string& instruction);
-    std::string processFor(const std::string& instruction);
-    std::string processRead(const std::string& instruction);
-    std::string processWrite(const std::string& instruction);
-    uint16_t getVariableOrValue(const std::string& token);
+    static std::string nextPid();
+    void appendInstruction(const std::string& text);
+    std::string generateLine();
+    void fuseSuperinstructions(size_t first);
+    int runSwitch(int maxSteps, bool record);
+    int runThreaded(int maxSteps, bool record);
+    void finishStep(const Instruction& instruction, LogRecord& entry, bool record);
+    void appendLog(const LogRecord& entry);
+    void generateSyntheticAccesses(class MemoryManager* memoryManager);
+    std::string describe(const LogRecord& entry) const;
+    std::string operandText(const Operand& operand) const;
+    void processDeclare(const Instruction& instruction, LogRecord& entry);
+    void processAdd(const Instruction& instruction, LogRecord& entry);
+    void processIncrement(const Instruction& instruction, LogRecord& entry);
+    void processSubtract(const Instruction& instruction, LogRecord& entry);
+    void processPrint(const Instruction& instruction, LogRecord& entry);
+    void processSleep(const Instruction& instruction, LogRecord& entry);
+    void processFor(const Instruction& instruction, LogRecord& entry);
+    void processEndFor(const Instruction& instruction);
+    void processRead(const Instruction& instruction, LogRecord& entry);
+    void processWrite(const Instruction& instruction, LogRecord& entry);
+    uint16_t operandValue(const Operand& operand);
 };
 
 #endif
@@ -0,0 +1,111 @@
+#include "process_archive.h"
+#include "../utils/clock.h"
+#include <algorithm>
+#include <sstream>
+
+std::string ProcessSummary::getViolationInfo() const {
+    if (!memoryViolation) return "";
+    
+    std::ostringstream oss;
+    oss << "Process " << name << " shut down due to memory access violation error that occurred at " 
+        << Clock::format(violationTimestamp) << ". 0x" << std::hex << violationAddress << " invalid.";
+    return oss.str();
+}
+
+ProcessArchive::ProcessArchive(const std::string& path) : path(path) {
+}
+
+bool ProcessArchive::open() {
+    std::lock_guard<std::mutex> lock(archiveMutex);
+    file.open(path, std::ios::out | std::ios::trunc | std::ios::binary);
+    writeOffset = 0;
+    return file.is_open();
+}
+
+void ProcessArchive::add(const Process& process) {
+    ProcessSummary summary;
+    summary.name = process.name;
+    summary.pid = process.pid;
+    summary.allocatedMemory = process.allocatedMemory;
+    summary.arrivalTime = process.arrivalTime;
+    summary.creationTimestamp = process.creationTimestamp;
+    summary.completionTimestamp = process.completionTimestamp;
+    summary.executedInstructions = process.executedInstructions;
+    summary.totalInstructions = process.totalInstructions;
+    summary.waitingTime = process.waitingTime;
+    summary.turnaroundTime = process.turnaroundTime;
+    summary.responseTime = process.responseTime;
+    summary.dispatches = process.dispatches;
+    summary.migrations = process.migrations;
+    summary.memoryViolation = process.memoryViolationOccurred;
+    summary.violationAddress = process.violationAddress;
+    summary.violationTimestamp = process.violationTimestamp;
+    
+    std::vector<std::string> log = process.formatLog();
+    std::string block = "PROCESS " + process.pid + " " + process.name + "\n";
+    size_t header = block.size();
+    for (const auto& line : log) {
+        block += line;
+        block += '\n';
+    }
+    block += "END_PROCESS\n";
+    
+    std::lock_guard<std::mutex> lock(archiveMutex);
+    if (file.is_open()) {
+        summary.logOffset = writeOffset + header;
+        summary.logLines = static_cast<uint32_t>(log.size());
+        file.write(block.data(), block.size());
+        file.flush();
+        writeOffset += block.size();
+    }
+    
+    size_t position = records.size();
+    records.push_back(summary);
+    index[summary.name] = position;
+    index[summary.pid] = position;
+    
+    auto it = std::upper_bound(arrivalOrder.begin(), arrivalOrder.end(), position,
+        [this](size_t a, size_t b) {
+            return records[a].arrivalTime < records[b].arrivalTime;
+        });
+    arrivalOrder.insert(it, position);
+}
+
+bool ProcessArchive::find(const std::string& nameOrPid, ProcessSummary& summary) const {
+    std::lock_guard<std::mutex> lock(archiveMutex);
+    auto it = index.find(nameOrPid);
+    if (it == index.end()) return false;
+    
+    summary = records[it->second];
+    return true;
+}
+
+std::vector<ProcessSummary> ProcessArchive::summaries() const {
+    std::lock_guard<std::mutex> lock(archiveMutex);
+    std::vector<ProcessSummary> ordered;
+    ordered.reserve(arrivalOrder.size());
+    for (size_t position : arrivalOrder) {
+        ordered.push_back(records[position]);
+    }
+    return ordered;
+}
+
+std::vector<std::string> ProcessArchive::readLog(const ProcessSummary& summary) const {
+    std::vector<std::string> lines;
+    if (summary.logLines == 0) return lines;
+    
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) return lines;
+    
+    in.seekg(static_cast<std::streamoff>(summary.logOffset));
+    std::string line;
+    while (lines.size() < summary.logLines && std::getline(in, line)) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+size_t ProcessArchive::size() const {
+    std::lock_guard<std::mutex> lock(archiveMutex);
+    return records.size();
+}
@@ -0,0 +1,63 @@
+#ifndef PROCESS_ARCHIVE_H
+#define PROCESS_ARCHIVE_H
+
+#include "process.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <fstream>
+#include <mutex>
+#include <cstdint>
+
+// What is kept in memory for a finished process. The log itself lives in the
+// archive file; logOffset and logLines locate it there.
+struct ProcessSummary {
+    std::string name;
+    std::string pid;
+    size_t allocatedMemory = 0;
+    int arrivalTime = 0;
+    int64_t creationTimestamp = 0;
+    int64_t completionTimestamp = 0;
+    int executedInstructions = 0;
+    int totalInstructions = 0;
+    int waitingTime = 0;
+    int turnaroundTime = 0;
+    int responseTime = -1;
+    int dispatches = 0;
+    int migrations = 0;
+    bool memoryViolation = false;
+    uint32_t violationAddress = 0;
+    int64_t violationTimestamp = 0;
+    uint64_t logOffset = 0;
+    uint32_t logLines = 0;
+    
+    std::string getViolationInfo() const;
+};
+
+// Finished processes are turned into summaries, indexed by name and pid, and
+// their logs are appended to a single file that is truncated when the
+// archive is opened. Logs are read back from the file only when asked for.
+class ProcessArchive {
+public:
+    explicit ProcessArchive(const std::string& path);
+    
+    bool open();
+    void add(const Process& process);
+    bool find(const std::string& nameOrPid, ProcessSummary& summary) const;
+    std::vector<ProcessSummary> summaries() const;
+    std::vector<std::string> readLog(const ProcessSummary& summary) const;
+    size_t size() const;
+    const std::string& getPath() const { return path; }
+    
+private:
+    std::string path;
+    std::ofstream file;
+    uint64_t writeOffset = 0;
+    mutable std::mutex archiveMutex;
+    
+    std::vector<ProcessSummary> records;
+    std::vector<size_t> arrivalOrder;
+    std::unordered_map<std::string, size_t> index;
+};
+
+#endif
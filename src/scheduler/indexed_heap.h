@@ -0,0 +1,136 @@
+#ifndef INDEXED_HEAP_H
+#define INDEXED_HEAP_H
+
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+// Binary heap of distinct items ordered by an integer key, with an index from
+// item to heap slot so a queued item's key can be changed or the item removed
+// in O(log n). With the default Compare the smallest key is on top.
+template <typename T, typename Compare = std::less<int64_t>>
+class IndexedHeap {
+public:
+    bool empty() const { return entries.empty(); }
+    size_t size() const { return entries.size(); }
+    bool contains(const T& item) const { return index.count(item) > 0; }
+
+    const T& top() const { return entries.front().item; }
+    int64_t topKey() const { return entries.front().key; }
+
+    // Inserts the item, or moves it to its new key if it is already queued.
+    void push(const T& item, int64_t key) {
+        auto it = index.find(item);
+        if (it != index.end()) {
+            update(it->second, key);
+            return;
+        }
+
+        entries.push_back(Entry{item, key});
+        index[item] = entries.size() - 1;
+        siftUp(entries.size() - 1);
+    }
+
+    bool pop(T& item) {
+        if (entries.empty()) {
+            return false;
+        }
+        item = entries.front().item;
+        removeAt(0);
+        return true;
+    }
+
+    bool erase(const T& item) {
+        auto it = index.find(item);
+        if (it == index.end()) {
+            return false;
+        }
+        removeAt(it->second);
+        return true;
+    }
+
+    bool updateKey(const T& item, int64_t key) {
+        auto it = index.find(item);
+        if (it == index.end()) {
+            return false;
+        }
+        update(it->second, key);
+        return true;
+    }
+
+private:
+    struct Entry {
+        T item;
+        int64_t key;
+    };
+
+    std::vector<Entry> entries;
+    std::unordered_map<T, size_t> index;
+    Compare before;
+
+    void update(size_t slot, int64_t key) {
+        int64_t old = entries[slot].key;
+        entries[slot].key = key;
+        if (before(key, old)) {
+            siftUp(slot);
+        } else {
+            siftDown(slot);
+        }
+    }
+
+    void removeAt(size_t slot) {
+        index.erase(entries[slot].item);
+        if (slot + 1 == entries.size()) {
+            entries.pop_back();
+            return;
+        }
+
+        entries[slot] = entries.back();
+        entries.pop_back();
+        index[entries[slot].item] = slot;
+        siftDown(slot);
+        siftUp(slot);
+    }
+
+    void place(size_t slot, Entry entry) {
+        entries[slot] = entry;
+        index[entry.item] = slot;
+    }
+
+    void siftUp(size_t slot) {
+        Entry entry = entries[slot];
+        while (slot > 0) {
+            size_t parent = (slot - 1) / 2;
+            if (!before(entry.key, entries[parent].key)) {
+                break;
+            }
+            place(slot, entries[parent]);
+            slot = parent;
+        }
+        place(slot, entry);
+    }
+
+    void siftDown(size_t slot) {
+        Entry entry = entries[slot];
+        size_t count = entries.size();
+        while (true) {
+            size_t child = 2 * slot + 1;
+            if (child >= count) {
+                break;
+            }
+            if (child + 1 < count && before(entries[child + 1].key, entries[child].key)) {
+                child++;
+            }
+            if (!before(entries[child].key, entry.key)) {
+                break;
+            }
+            place(slot, entries[child]);
+            slot = child;
+        }
+        place(slot, entry);
+    }
+};
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef LEVEL_QUEUE_H
+#define LEVEL_QUEUE_H
+
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#if defined(_MSC_VER) && !defined(__GNUC__)
+#include <intrin.h>
+#endif
+
+// Ready queue split into FIFO levels, level 0 being the most urgent. One bit
+// per non-empty level lets push, pop and the most-urgent-level lookup run in
+// O(1) with a count-trailing-zeros, however many levels are in use. The queues
+// are not synchronized; the caller holds a lock around push/pop. The bitmap
+// is atomic so a running core can ask whether something more urgent is
+// waiting without taking that lock.
+template <typename T>
+class LevelQueue {
+public:
+    static const int MAX_LEVELS = 64;
+
+    LevelQueue() : queues(MAX_LEVELS) {}
+
+    LevelQueue(const LevelQueue&) = delete;
+    LevelQueue& operator=(const LevelQueue&) = delete;
+
+    void push(int level, T item) {
+        level = clamp(level);
+        queues[level].push_back(std::move(item));
+        occupied.fetch_or(1ull << level, std::memory_order_release);
+        count++;
+    }
+
+    bool pop(T& item) {
+        int level = highestLevel();
+        if (level == MAX_LEVELS) {
+            return false;
+        }
+
+        item = std::move(queues[level].front());
+        queues[level].pop_front();
+        if (queues[level].empty()) {
+            occupied.fetch_and(~(1ull << level), std::memory_order_release);
+        }
+        count--;
+        return true;
+    }
+
+    // Most urgent non-empty level, or MAX_LEVELS when every level is empty.
+    int highestLevel() const {
+        uint64_t bits = occupied.load(std::memory_order_acquire);
+        return bits ? lowestBit(bits) : MAX_LEVELS;
+    }
+
+    // Moves everything to level 0, keeping the more urgent levels in front.
+    void boost() {
+        for (int level = 1; level < MAX_LEVELS; ++level) {
+            for (T& item : queues[level]) {
+                queues[0].push_back(std::move(item));
+            }
+            queues[level].clear();
+        }
+        occupied.store(count > 0 ? 1ull : 0ull, std::memory_order_release);
+    }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+private:
+    std::vector<std::deque<T>> queues;
+    std::atomic<uint64_t> occupied{0};
+    size_t count = 0;
+
+    // Index of the lowest set bit; bits must be non-zero.
+    static int lowestBit(uint64_t bits) {
+#if defined(__GNUC__)
+        return __builtin_ctzll(bits);
+#elif defined(_MSC_VER) && defined(_WIN64)
+        unsigned long index;
+        _BitScanForward64(&index, bits);
+        return static_cast<int>(index);
+#else
+        int index = 0;
+        while (!(bits & 1)) {
+            bits >>= 1;
+            index++;
+        }
+        return index;
+#endif
+    }
+
+    static int clamp(int level) {
+        return level < 0 ? 0 : (level >= MAX_LEVELS ? MAX_LEVELS - 1 : level);
+    }
+};
+
+#endif
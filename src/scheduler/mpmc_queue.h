@@ -0,0 +1,97 @@
+#ifndef MPMC_QUEUE_H
+#define MPMC_QUEUE_H
+
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+// Bounded multi-producer/multi-consumer ring after Dmitry Vyukov's design.
+// Every cell carries a sequence number that tells producers and consumers
+// whether it is free for the current lap, so a push or pop is one
+// compare-and-swap on its position counter plus one release store. push()
+// and pop() return false when the ring is full or empty instead of blocking.
+template <typename T>
+class MpmcQueue {
+public:
+    explicit MpmcQueue(size_t capacity = 1024) {
+        size_t rounded = 2;
+        while (rounded < capacity) rounded <<= 1;
+        mask = rounded - 1;
+        cells.reset(new Cell[rounded]);
+        for (size_t i = 0; i < rounded; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    bool push(T item) {
+        size_t position = enqueuePosition.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells[position & mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (difference == 0) {
+                if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->item = item;
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& item) {
+        size_t position = dequeuePosition.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells[position & mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+            if (difference == 0) {
+                if (dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = dequeuePosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        item = cell->item;
+        cell->sequence.store(position + mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Approximate while other threads are pushing or popping.
+    size_t size() const {
+        size_t enqueued = enqueuePosition.load(std::memory_order_relaxed);
+        size_t dequeued = dequeuePosition.load(std::memory_order_relaxed);
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+    size_t capacity() const { return mask + 1; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T item;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask = 0;
+    alignas(64) std::atomic<size_t> enqueuePosition{0};
+    alignas(64) std::atomic<size_t> dequeuePosition{0};
+};
+
+#endif
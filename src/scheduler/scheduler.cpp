@@ -1,5 +1,6 @@
 #include "scheduler.h"
 #include "../utils/utils.h"
+#include "../utils/clock.h"
 #include <iostream>
 #include <iomanip>
 #include <fstream>
@@ -8,24 +9,78 @@
 #include <chrono>
 #include <map>
 #include <random>
+#include <climits>
+#include <sstream>
+#include <cstdio>
 
 Scheduler::Scheduler(std::unique_ptr<SystemConfig> cfg) 
     : config(std::move(cfg)) {
     
     runningProcesses.resize(config->numCpu, nullptr);
+    for (int i = 0; i < config->numCpu; ++i) {
+        coreQueues.push_back(std::make_unique<CoreQueue>());
+    }
+    if (config->scheduler == "mlfq" || config->scheduler == "priority") {
+        queueMode = ReadyQueueMode::LEVELED;
+    } else if (config->scheduler == "sjf" || config->scheduler == "srtf") {
+        queueMode = ReadyQueueMode::SHORTEST;
+    } else if (config->scheduler != "fcfs") {
+        queueMode = config->readyQueue == "mpmc" ? ReadyQueueMode::MPMC : ReadyQueueMode::PER_CORE;
+    }
+    nextBoostTick.store(config->boostInterval);
     coreQuantumCounters.resize(config->numCpu, 0);
+    adaptiveQuantum = config->scheduler == "rr" && config->quantumTarget > 0;
+    idleSince.resize(config->numCpu, 0);
+    preemptRequested.reset(new std::atomic<bool>[config->numCpu]);
+    for (int i = 0; i < config->numCpu; ++i) {
+        preemptRequested[i] = false;
+    }
     systemStartTime = std::chrono::high_resolution_clock::now();
     
+    bool resume = config->persistentBackingStore && std::ifstream(checkpointPath).good();
+    
     memoryManager = std::make_unique<MemoryManager>(
         config->maxOverallMemory, 
         config->memoryPerFrame,
         config->minMemoryPerProcess,
-        config->maxMemoryPerProcess
+        config->maxMemoryPerProcess,
+        config->backingStoreFiles,
+        "csopesy-backing-store.txt",
+        config->persistentBackingStore,
+        resume
     );
+    memoryManager->setPreferIdleVictims(config->evictPreferIdle);
+    memoryManager->setCommitLimit(config->commitLimit);
+    if (!archive.open()) {
+        std::cerr << "Warning: cannot open " << archive.getPath() << ", finished process logs will not be kept." << std::endl;
+    }
+    Process::setDispatchMode(config->interpreterDispatch == "switch" ? DispatchMode::SWITCH : DispatchMode::THREADED);
+    Process::setLogDepth(config->logDepth);
+    if (config->syntheticAccess == "sequential") {
+        Process::setAccessPattern(AccessPattern::SEQUENTIAL);
+    } else if (config->syntheticAccess == "random") {
+        Process::setAccessPattern(AccessPattern::RANDOM);
+    } else {
+        Process::setAccessPattern(AccessPattern::NONE);
+    }
+    
+    if (config->hasSeed) {
+        Utils::setRandomSeed(config->seed);
+    }
+    workloadRandom.seed(Utils::deriveSeed("scheduler"));
+    
+    if (resume) {
+        int restored = loadCheckpoint();
+        std::cout << "Resumed " << restored << " process(es) from " << checkpointPath << std::endl;
+    }
 }
 
 Scheduler::~Scheduler() {
     stop();
+    
+    if (config->persistentBackingStore) {
+        saveCheckpoint();
+    }
 }
 
 bool Scheduler::start() {
@@ -36,6 +91,7 @@ bool Scheduler::start() {
     
     shouldStop.store(false);
     isRunning.store(true);
+    Clock::start();
     
     // Enable dummy process generation by default when starting
     dummyProcessGenerationEnabled.store(true);
@@ -60,6 +116,7 @@ bool Scheduler::startTestMode() {
     
     shouldStop.store(false);
     isRunning.store(true);
+    Clock::start();
     
     // Test mode doesn't need dummy process generation since it has its own creator
     // But we'll enable it for consistency
@@ -93,76 +150,53 @@ void Scheduler::stop() {
     }
     
     coreWorkers.clear();
+    Clock::stop();
     std::cout << "Scheduler stopped successfully." << std::endl;
 }
 
 void Scheduler::coreWorkerThread(int coreId) {
     while (!shouldStop.load()) {
-        std::shared_ptr<Process> currentProcess = nullptr;
+        // Only this core writes its slot in runningProcesses, so reading it
+        // needs no lock. processMutex is taken only to dispatch.
+        std::shared_ptr<Process> currentProcess = runningProcesses[coreId];
+        wakeSleepers();
+        boostPriorities();
+        tuneQuantumScale();
         
-        {
-            // Only use global lock for strict FCFS scheduling
-            static std::mutex fcfsGlobalLock;
-            std::unique_ptr<std::unique_lock<std::mutex>> globalLock = nullptr;
-            
-            // For FCFS, we need strict ordering, so use global lock
-            // For other schedulers, allow parallel access to ready queue
-            if (config->scheduler == "fcfs") {
-                globalLock = std::make_unique<std::unique_lock<std::mutex>>(fcfsGlobalLock);
+        if (!currentProcess && queueMode == ReadyQueueMode::GLOBAL) {
+            std::lock_guard<std::mutex> lock(processMutex);
+            if (!readyQueue.empty()) {
+                currentProcess = readyQueue.begin()->second;
+                readyQueue.erase(readyQueue.begin());
+                assignToCore(coreId, currentProcess);
             }
-            
-            std::unique_lock<std::mutex> lock(processMutex);
-
-            currentProcess = runningProcesses[coreId];
-
-            if (!currentProcess && !readyQueue.empty()) {
-                if (config->scheduler == "fcfs") {
-                    // FCFS: strict arrival time ordering
-                    int minArrival = INT_MAX;
-                    for (const auto& proc : runningProcesses) {
-                        if (proc && !proc->isComplete() && proc->arrivalTime < minArrival) {
-                            minArrival = proc->arrivalTime;
-                        }
-                    }
-                    auto it = std::min_element(readyQueue.begin(), readyQueue.end(), [](const std::shared_ptr<Process>& a, const std::shared_ptr<Process>& b) {
-                        return a->arrivalTime < b->arrivalTime;
-                    });
-                    if ((*it)->arrivalTime <= minArrival) {
-                        currentProcess = *it;
-                        readyQueue.erase(it);
-                        runningProcesses[coreId] = currentProcess;
-                        currentProcess->state = ProcessState::RUNNING;
-                        currentProcess->coreAssignment = coreId;
-                    }
-                } else {
-                    // For RR and other schedulers: just pick the first available process
-                    currentProcess = readyQueue.front();
-                    readyQueue.erase(readyQueue.begin());
-                    runningProcesses[coreId] = currentProcess;
-                    currentProcess->state = ProcessState::RUNNING;
-                    currentProcess->coreAssignment = coreId;
-                }
+        }
+        
+        if (!currentProcess && queueMode == ReadyQueueMode::LEVELED) {
+            std::lock_guard<std::mutex> lock(processMutex);
+            if (levelQueue.pop(currentProcess)) {
+                assignToCore(coreId, currentProcess);
             }
         }
         
-        if (currentProcess) {
-            if (currentProcess->sleepRemaining > 0) {
-                currentProcess->sleepRemaining--;
-                
-                if (currentProcess->sleepRemaining == 0) {
-                    currentProcess->state = ProcessState::READY;
-                    
-                    std::lock_guard<std::mutex> lock(processMutex);
-                    currentProcess->coreAssignment = -1;
-                    readyQueue.push_back(currentProcess);
-                    runningProcesses[coreId] = nullptr;
-                    processCV.notify_one();
-                } else {
-                    std::this_thread::sleep_for(std::chrono::milliseconds(config->delayPerExec));
-                }
-                continue;
+        if (!currentProcess && queueMode == ReadyQueueMode::SHORTEST) {
+            std::lock_guard<std::mutex> lock(processMutex);
+            Process* shortest = nullptr;
+            if (shortestQueue.pop(shortest)) {
+                currentProcess = shortest->shared_from_this();
+                assignToCore(coreId, currentProcess);
             }
-            
+        }
+        
+        if (!currentProcess && (queueMode == ReadyQueueMode::PER_CORE || queueMode == ReadyQueueMode::MPMC)) {
+            currentProcess = takeReady(coreId);
+            if (currentProcess) {
+                std::lock_guard<std::mutex> lock(processMutex);
+                assignToCore(coreId, currentProcess);
+            }
+        }
+        
+        if (currentProcess) {
             int instructionsPerChunk = 1; 
             int effectiveDelay = config->delayPerExec; 
             
@@ -170,12 +204,23 @@ void Scheduler::coreWorkerThread(int coreId) {
                 instructionsPerChunk = 8; 
             }
             
+            // The whole remaining chunk goes to the interpreter in one call;
+            // every instruction still costs one tick.
             int instructionsExecuted = 0;
             while (instructionsExecuted < instructionsPerChunk && !currentProcess->isComplete()) {
-                std::string logEntry = currentProcess->executeNextInstruction(memoryManager.get());
-                instructionsExecuted++;
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
-                memoryManager->incrementCpuTicks();
+                int steps = currentProcess->executeInstructions(memoryManager.get(), instructionsPerChunk - instructionsExecuted);
+                int ticks = std::max(1, steps);
+                instructionsExecuted += ticks;
+                std::this_thread::sleep_for(std::chrono::milliseconds(100 * ticks));
+                for (int tick = 0; tick < ticks; ++tick) {
+                    memoryManager->incrementCpuTicks();
+                }
+                cpuTick.fetch_add(ticks);
+                
+                if (config->scheduler == "srtf") {
+                    std::lock_guard<std::mutex> lock(processMutex);
+                    runningByRemaining.updateKey(coreId, currentProcess->remainingTime);
+                }
                 
                 if (currentProcess->isComplete()) {
                     break;
@@ -184,28 +229,62 @@ void Scheduler::coreWorkerThread(int coreId) {
                 if (currentProcess->state == ProcessState::WAITING && currentProcess->sleepRemaining > 0) {
                     break;
                 }
+                
+                if (queueMode == ReadyQueueMode::LEVELED && levelQueue.highestLevel() < currentProcess->priority) {
+                    break;
+                }
+                
+                if (preemptRequested[coreId].load()) {
+                    break;
+                }
             }
             
             if (currentProcess->isComplete()) {
+                coreQuantumCounters[coreId] = 0;
                 handleProcessCompletion(currentProcess);
                 
                 std::lock_guard<std::mutex> lock(processMutex);
-                runningProcesses[coreId] = nullptr;
+                releaseCore(coreId);
             }
             else if (currentProcess->state == ProcessState::WAITING && currentProcess->sleepRemaining > 0) {
+                if (config->scheduler == "rr") {
+                    endSlice(*currentProcess, coreQuantumCounters[coreId] + instructionsExecuted, true);
+                }
+                coreQuantumCounters[coreId] = 0;
+                {
+                    std::lock_guard<std::mutex> lock(processMutex);
+                    currentProcess->coreAssignment = -1;
+                    releaseCore(coreId);
+                }
+                addSleeper(currentProcess);
+            }
+            else if (preemptRequested[coreId].load()) {
+                preempt(coreId, currentProcess);
             }
-            else if (config->scheduler == "rr") {
+            else if (config->scheduler == "rr" || queueMode == ReadyQueueMode::LEVELED) {
                 coreQuantumCounters[coreId] += instructionsExecuted;
                 
-                if (coreQuantumCounters[coreId] >= config->quantumCycles) {
+                // A more urgent arrival preempts at once. Strict priority only
+                // rotates among equals; MLFQ demotes a process that used up
+                // its level's quantum.
+                int level = currentProcess->priority;
+                int quantum = config->scheduler == "mlfq" ? config->quantumForLevel(level)
+                            : adaptiveQuantum ? quantumFor(*currentProcess) : config->quantumCycles;
+                bool preempted = queueMode == ReadyQueueMode::LEVELED && levelQueue.highestLevel() < level;
+                bool expired = coreQuantumCounters[coreId] >= quantum;
+                if (config->scheduler == "priority" && levelQueue.highestLevel() > level) {
+                    expired = false;
+                }
+                
+                if (preempted || expired) {
+                    if (config->scheduler == "rr") {
+                        endSlice(*currentProcess, coreQuantumCounters[coreId], false);
+                    }
                     coreQuantumCounters[coreId] = 0;
-                    
-                    std::lock_guard<std::mutex> lock(processMutex);
-                    currentProcess->state = ProcessState::READY;
-                    currentProcess->coreAssignment = -1;
-                    readyQueue.push_back(currentProcess);
-                    runningProcesses[coreId] = nullptr;
-                    processCV.notify_one();
+                    if (expired && config->scheduler == "mlfq" && level < config->priorityLevels - 1) {
+                        currentProcess->priority = level + 1;
+                    }
+                    preempt(coreId, currentProcess);
                 }
             }
             
@@ -216,12 +295,330 @@ void Scheduler::coreWorkerThread(int coreId) {
             }
         } else {
             memoryManager->incrementIdleTicks();
+            cpuTick.fetch_add(1);
             std::unique_lock<std::mutex> lock(processMutex);
             processCV.wait_for(lock, std::chrono::milliseconds(50));
         }
     }
 }
 
+// Both helpers expect processMutex to be held by the caller.
+void Scheduler::assignToCore(int coreId, const std::shared_ptr<Process>& process) {
+    runningProcesses[coreId] = process;
+    process->state = ProcessState::RUNNING;
+    process->coreAssignment = coreId;
+    memoryManager->setProcessRunning(process->pid, true);
+    
+    int64_t now = Clock::now();
+    process->waitingTime += static_cast<int>(now - process->readySince);
+    if (process->responseTime == -1) {
+        process->responseTime = static_cast<int>(now - process->creationTimestamp);
+    }
+    
+    totalDispatches.fetch_add(1);
+    process->dispatches++;
+    if (process->lastCore >= 0 && process->lastCore != coreId) {
+        totalMigrations.fetch_add(1);
+        process->migrations++;
+    }
+    process->lastCore = coreId;
+    
+    preemptRequested[coreId] = false;
+    if (config->scheduler == "srtf") {
+        runningByRemaining.push(coreId, process->remainingTime);
+    }
+}
+
+void Scheduler::releaseCore(int coreId) {
+    runningByRemaining.erase(coreId);
+    idleSince[coreId] = cpuTick.load();
+    if (runningProcesses[coreId]) {
+        runningProcesses[coreId]->lastRanTick = idleSince[coreId];
+        memoryManager->setProcessRunning(runningProcesses[coreId]->pid, false);
+    }
+    runningProcesses[coreId] = nullptr;
+}
+
+void Scheduler::preempt(int coreId, const std::shared_ptr<Process>& process) {
+    {
+        std::lock_guard<std::mutex> lock(processMutex);
+        process->state = ProcessState::READY;
+        process->coreAssignment = -1;
+        releaseCore(coreId);
+    }
+    makeReady(process, coreId);
+}
+
+bool Scheduler::isWarm(const Process& process) const {
+    return config->affinityWindow > 0 && process.lastCore >= 0 &&
+           cpuTick.load() - process.lastRanTick <= static_cast<uint64_t>(config->affinityWindow);
+}
+
+// coreId is the core making the process ready, or -1 for any other thread.
+// With per-core queues a core requeues onto its own deque and everything else
+// goes to the inbox of the core it last ran on while that is still warm, or
+// of the least loaded core. The shared ring needs no lock
+// from either side; it only spins if all of its slots are taken.
+void Scheduler::makeReady(const std::shared_ptr<Process>& process, int coreId) {
+    process->readySince = Clock::now();
+    
+    if (queueMode == ReadyQueueMode::GLOBAL) {
+        std::lock_guard<std::mutex> lock(processMutex);
+        if (!readyQueue.emplace(std::make_pair(process->arrivalTime, process->pid), process).second) {
+            std::cerr << "Warning: " << process->name << " is already in the ready queue." << std::endl;
+        }
+    } else if (queueMode == ReadyQueueMode::LEVELED) {
+        std::lock_guard<std::mutex> lock(processMutex);
+        levelQueue.push(std::min<int>(process->priority, config->priorityLevels - 1), process);
+    } else if (queueMode == ReadyQueueMode::SHORTEST) {
+        std::lock_guard<std::mutex> lock(processMutex);
+        shortestQueue.push(process.get(), process->shortestFirstKey());
+        
+        // A process shorter than the longest running one takes that core,
+        // unless some core is idle and will pick it up anyway. The victim
+        // leaves the heap so the next arrival looks at the one after it.
+        bool coreIdle = std::find(runningProcesses.begin(), runningProcesses.end(), nullptr) != runningProcesses.end();
+        if (config->scheduler == "srtf" && !coreIdle && !runningByRemaining.empty() &&
+            process->remainingTime < runningByRemaining.topKey()) {
+            int victim = runningByRemaining.top();
+            runningByRemaining.erase(victim);
+            preemptRequested[victim] = true;
+        }
+    } else if (queueMode == ReadyQueueMode::MPMC) {
+        while (!sharedReadyQueue.push(process.get())) {
+            std::this_thread::yield();
+        }
+    } else if (coreId >= 0) {
+        coreQueues[coreId]->local.push(process.get());
+    } else {
+        CoreQueue* target = coreQueues.front().get();
+        if (isWarm(*process)) {
+            target = coreQueues[process->lastCore].get();
+        } else {
+            for (const auto& queue : coreQueues) {
+                if (queue->load() < target->load()) {
+                    target = queue.get();
+                }
+            }
+        }
+        
+        std::lock_guard<std::mutex> lock(target->inboxMutex);
+        target->inbox.push_back(process.get());
+        target->inboxSize.fetch_add(1);
+    }
+    processCV.notify_one();
+}
+
+void Scheduler::addSleeper(const std::shared_ptr<Process>& process) {
+    std::lock_guard<std::mutex> lock(timerMutex);
+    process->wakeTick = cpuTick.load() + process->sleepRemaining;
+    sleepers.schedule(process.get(), process->wakeTick);
+    sleeperCount.fetch_add(1);
+}
+
+// Called by every core at the top of its loop. Whichever core gets the timer
+// lock moves the wheel up to the current tick; the others carry on.
+void Scheduler::wakeSleepers() {
+    if (sleeperCount.load() == 0) {
+        return;
+    }
+    
+    std::vector<Process*> expired;
+    {
+        std::unique_lock<std::mutex> lock(timerMutex, std::try_to_lock);
+        if (!lock.owns_lock()) {
+            return;
+        }
+        sleepers.advance(cpuTick.load(), expired);
+        sleeperCount.fetch_sub(expired.size());
+        for (Process* process : expired) {
+            process->wakeTick = 0;
+        }
+    }
+    
+    for (Process* process : expired) {
+        process->sleepRemaining = 0;
+        process->state = ProcessState::READY;
+        makeReady(process->shared_from_this());
+    }
+}
+
+// Every mlfq-boost ticks all processes go back to the top level, so long jobs
+// that sank to the bottom cannot be starved by a stream of short ones.
+void Scheduler::boostPriorities() {
+    if (config->scheduler != "mlfq" || config->boostInterval == 0) {
+        return;
+    }
+    
+    uint64_t due = nextBoostTick.load();
+    uint64_t tick = cpuTick.load();
+    if (tick < due || !nextBoostTick.compare_exchange_strong(due, tick + config->boostInterval)) {
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(processMutex);
+    for (const auto& process : allProcesses) {
+        process->priority = 0;
+    }
+    levelQueue.boost();
+}
+
+int Scheduler::quantumFor(const Process& process) const {
+    int base = process.quantum > 0 ? process.quantum : config->quantumCycles;
+    int quantum = static_cast<int>((static_cast<int64_t>(base) * quantumScale.load() + 50) / 100);
+    return std::min(config->maxQuantum, std::max(config->minQuantum, quantum));
+}
+
+// Counts the quantum a round robin slice was granted. Under adaptive round
+// robin the process's own quantum then moves halfway towards the point where
+// it slept, doubles after a full slice, and after a slice with a major page
+// fault moves towards the middle of the slice, where on average the fault
+// hit. Faults are sampled once per slice so the running core never takes
+// the memory lock between instructions.
+void Scheduler::endSlice(Process& process, int ran, bool slept) {
+    int granted = adaptiveQuantum ? quantumFor(process) : config->quantumCycles;
+    int bucket = 0;
+    while (bucket < QUANTUM_BUCKETS - 1 && (granted >> (bucket + 1)) > 0) {
+        bucket++;
+    }
+    quantumHistogram[bucket].fetch_add(1);
+    quantumSlices.fetch_add(1);
+    quantumGranted.fetch_add(granted);
+    
+    if (!adaptiveQuantum) {
+        return;
+    }
+    
+    bool faulted = false;
+    ProcessMemoryStats stats;
+    if (memoryManager->getProcessMemoryStats(process.pid, stats)) {
+        faulted = stats.majorFaults > process.majorFaultsSeen;
+        process.majorFaultsSeen = stats.majorFaults;
+    }
+    
+    int base = process.quantum > 0 ? process.quantum : config->quantumCycles;
+    if (slept || faulted) {
+        int burst = slept ? ran : ran / 2;
+        burst = static_cast<int>(static_cast<int64_t>(burst) * 100 / quantumScale.load());
+        process.quantum = std::max(1, (base + burst + 1) / 2);
+    } else {
+        process.quantum = std::min(config->maxQuantum, base * 2);
+    }
+}
+
+// Once a second the core that wins the nextTuneAt exchange compares the
+// dispatch rate of the last window with quantum-target and scales every
+// quantum by 5/4 up or down when the rate is more than 10% off. Only that
+// core touches lastTuneAt and tuneDispatches for the window; they are atomic
+// because the next window's winner may be another core.
+void Scheduler::tuneQuantumScale() {
+    if (!adaptiveQuantum) {
+        return;
+    }
+    
+    int64_t now = Clock::now();
+    int64_t due = nextTuneAt.load();
+    if (now < due || !nextTuneAt.compare_exchange_strong(due, now + 1000)) {
+        return;
+    }
+    
+    uint64_t dispatches = totalDispatches.load();
+    if (due != 0) {
+        double rate = (dispatches - tuneDispatches.load()) * 1000.0 / std::max<int64_t>(1, now - lastTuneAt.load());
+        switchRate.store(rate);
+        
+        int scale = quantumScale.load();
+        if (rate > config->quantumTarget * 1.1) {
+            scale = std::min(100 * config->maxQuantum, scale * 5 / 4 + 1);
+        } else if (rate < config->quantumTarget * 0.9) {
+            scale = std::max(1, scale * 4 / 5);
+        }
+        quantumScale.store(scale);
+    }
+    lastTuneAt.store(now);
+    tuneDispatches.store(dispatches);
+}
+
+// Under strict priority, processes started from the console begin at the top
+// level and generated batch processes at the bottom. MLFQ starts everything at
+// the top and lets the quanta sort them out.
+int Scheduler::startingLevel(bool batch) const {
+    return config->scheduler == "priority" && batch ? config->priorityLevels - 1 : 0;
+}
+
+// Queued processes are owned by allProcesses, which only drops them once they
+// have finished, so the raw pointers in the run queues stay valid.
+std::shared_ptr<Process> Scheduler::takeReady(int coreId) {
+    Process* process = nullptr;
+    if (queueMode == ReadyQueueMode::MPMC) {
+        return sharedReadyQueue.pop(process) ? process->shared_from_this() : nullptr;
+    }
+    
+    CoreQueue& own = *coreQueues[coreId];
+    if (own.inboxSize.load() > 0) {
+        std::lock_guard<std::mutex> lock(own.inboxMutex);
+        for (Process* process : own.inbox) {
+            own.local.push(process);
+        }
+        own.inbox.clear();
+        own.inboxSize.store(0);
+    }
+    
+    if (own.local.take(process)) {
+        return process->shared_from_this();
+    }
+    
+    size_t minimum = 1;
+    if (config->affinityWindow > 0 && cpuTick.load() - idleSince[coreId] <= static_cast<uint64_t>(config->affinityWindow)) {
+        minimum = 2;
+    }
+    
+    CoreQueue* victim = nullptr;
+    for (const auto& queue : coreQueues) {
+        if (queue.get() != &own && queue->load() >= minimum && (!victim || queue->load() > victim->load())) {
+            victim = queue.get();
+        }
+    }
+    if (!victim) {
+        return nullptr;
+    }
+    
+    if (victim->local.take(process)) {
+        return process->shared_from_this();
+    }
+    
+    std::lock_guard<std::mutex> lock(victim->inboxMutex);
+    if (victim->inbox.empty()) {
+        return nullptr;
+    }
+    process = victim->inbox.front();
+    victim->inbox.pop_front();
+    victim->inboxSize.fetch_sub(1);
+    return process->shared_from_this();
+}
+
+// Callers hold processMutex unless a lock-free queue is in use.
+size_t Scheduler::readyCount() const {
+    if (queueMode == ReadyQueueMode::GLOBAL) {
+        return readyQueue.size();
+    }
+    if (queueMode == ReadyQueueMode::SHORTEST) {
+        return shortestQueue.size();
+    }
+    if (queueMode == ReadyQueueMode::LEVELED) {
+        return levelQueue.size();
+    }
+    if (queueMode == ReadyQueueMode::MPMC) {
+        return sharedReadyQueue.size();
+    }
+    
+    size_t count = 0;
+    for (const auto& queue : coreQueues) {
+        count += queue->load();
+    }
+    return count;
+}
+
 void Scheduler::processCreatorThread() {
     while (!shouldStop.load()) {
         if (dummyProcessGenerationEnabled.load()) {
@@ -233,7 +630,7 @@ void Scheduler::processCreatorThread() {
                 for (const auto& process : runningProcesses) {
                     if (process != nullptr) activeCores++;
                 }
-                queueSize = readyQueue.size();
+                queueSize = readyCount();
             }
             
             int totalWorkload = activeCores + queueSize;
@@ -289,7 +686,7 @@ void Scheduler::testModeProcessCreator() {
             for (const auto& process : runningProcesses) {
                 if (process != nullptr) activeCores++;
             }
-            queueSize = readyQueue.size();
+            queueSize = readyCount();
         }
         
         int totalWorkload = activeCores + queueSize;
@@ -313,15 +710,16 @@ void Scheduler::handleProcessCompletion(std::shared_ptr<Process> process) {
     
     if (memoryManager) {
         memoryManager->deallocateMemory(process->pid);
+        admitPending();
     }
     
+    // The summary and archived log replace the process object; once the core
+    // lets go of it the process and its log are freed.
+    archive.add(*process);
+    
     {
         std::lock_guard<std::mutex> lock(processMutex);
-        auto it = std::upper_bound(terminatedProcesses.begin(), terminatedProcesses.end(), process,
-            [](const std::shared_ptr<Process>& a, const std::shared_ptr<Process>& b) {
-                return a->arrivalTime < b->arrivalTime;
-            });
-        terminatedProcesses.insert(it, process);
+        allProcesses.erase(std::remove(allProcesses.begin(), allProcesses.end(), process), allProcesses.end());
     }
 }
 
@@ -333,9 +731,6 @@ bool Scheduler::createProcess(const std::string& name) {
         processName = "process" + std::to_string(processCounter.fetch_add(1));
     }
     
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    
     std::vector<size_t> validMemorySizes;
     size_t minMemory = memoryManager->getMinMemoryPerProcess();
     size_t maxMemory = memoryManager->getMaxMemoryPerProcess();
@@ -350,107 +745,309 @@ bool Scheduler::createProcess(const std::string& name) {
         validMemorySizes.push_back(minMemory);
     }
     
-    std::uniform_int_distribution<> sizeDist(0, validMemorySizes.size() - 1);
-    size_t memorySize = validMemorySizes[sizeDist(gen)];
-    
-    static std::mutex creationLock;
-    static int strictArrivalCounter = 0;
-    std::lock_guard<std::mutex> creationGuard(creationLock);
+    std::lock_guard<std::mutex> creationGuard(creationMutex);
+    size_t memorySize = validMemorySizes[workloadRandom.range(0, static_cast<int>(validMemorySizes.size()) - 1)];
     auto process = std::make_shared<Process>(processName, memorySize);
     process->arrivalTime = ++strictArrivalCounter;
+    process->priority = startingLevel(name.empty());
     
-    bool allocated = false;
-    if (!memoryManager->allocateMemory(process->pid, memorySize)) {
-        for (auto it = validMemorySizes.rbegin(); it != validMemorySizes.rend(); ++it) {
-            if (memoryManager->allocateMemory(process->pid, *it)) {
-                memorySize = *it;
-                process->allocatedMemory = memorySize;
-                allocated = true;
-                break;
+    int baseInstructionCount = workloadRandom.range(config->minInstructions, config->maxInstructions);
+    process->generateInstructions(baseInstructionCount);
+    
+    std::vector<size_t> sizes = {memorySize};
+    sizes.insert(sizes.end(), validMemorySizes.rbegin(), validMemorySizes.rend());
+    return submit(process, sizes, !name.empty());
+}
+
+bool Scheduler::createProcess(const std::string& name, size_t memorySize) {
+    ensureSchedulerStarted();
+    
+    std::lock_guard<std::mutex> creationGuard(creationMutex);
+    auto process = std::make_shared<Process>(name, memorySize);
+    process->arrivalTime = ++strictArrivalCounter;
+    process->priority = startingLevel(false);
+    
+    int baseInstructionCount = workloadRandom.range(config->minInstructions, config->maxInstructions);
+    process->generateInstructions(baseInstructionCount);
+    return submit(process, {memorySize}, true);
+}
+
+bool Scheduler::createProcess(const std::string& name, size_t memorySize, const std::vector<std::string>& instructions) {
+    ensureSchedulerStarted();
+    
+    if (instructions.size() < 1 || instructions.size() > 50) {
+        std::cout << "Invalid command" << std::endl;
+        return false;
+    }
+    
+    std::lock_guard<std::mutex> creationGuard(creationMutex);
+    auto process = std::make_shared<Process>(name, memorySize, instructions);
+    process->arrivalTime = ++strictArrivalCounter;
+    process->priority = startingLevel(false);
+    return submit(process, {memorySize}, true);
+}
+
+// Tries each size in turn. If none fits, or earlier processes are already
+// waiting, the process joins the admission queue; only a full queue turns it
+// away. announce prints the outcome for console-created processes.
+bool Scheduler::submit(const std::shared_ptr<Process>& process, const std::vector<size_t>& sizes, bool announce) {
+    bool queueEmpty;
+    {
+        std::lock_guard<std::mutex> lock(admissionMutex);
+        queueEmpty = pendingAdmission.empty();
+    }
+    
+    if (queueEmpty) {
+        for (size_t size : sizes) {
+            if (memoryManager->allocateMemory(process->pid, size)) {
+                process->allocatedMemory = size;
+                launch(process);
+                return true;
             }
         }
-        
-        if (!allocated) {
+    }
+    
+    // Only the first size that could ever be granted is queued; a request no
+    // amount of freed memory satisfies is turned away so it cannot hold up
+    // the processes behind it.
+    auto fits = std::find_if(sizes.begin(), sizes.end(), [this](size_t size) {
+        return memoryManager->canEverAllocate(size);
+    });
+    
+    bool first;
+    {
+        std::lock_guard<std::mutex> lock(admissionMutex);
+        if (fits == sizes.end()) {
+            admissionRejected++;
+            if (announce) {
+                std::cout << "Invalid memory allocation: " << process->name << " can never fit in memory" << std::endl;
+            }
+            return false;
+        }
+        if (pendingAdmission.size() >= config->admissionLimit) {
+            admissionRejected++;
+            if (announce) {
+                std::cout << "Invalid memory allocation: admission queue is full" << std::endl;
+            }
             return false;
         }
+        
+        process->allocatedMemory = *fits;
+        pendingAdmission.push_back(PendingAdmission{process, Clock::now()});
+        first = pendingAdmission.size() == 1;
+        if (announce) {
+            std::cout << "Process " << process->name << " is waiting for memory (position "
+                      << pendingAdmission.size() << " in the admission queue)." << std::endl;
+        }
     }
     
-    int baseInstructionCount = Utils::generateRandomInt(
-        config->minInstructions, config->maxInstructions);
-    process->generateInstructions(baseInstructionCount);
+    // A completion between the failed allocation and the push found the queue
+    // empty and admitted nothing, so the head retries once itself.
+    if (first) {
+        admitPending();
+    }
+    return true;
+}
+
+void Scheduler::launch(const std::shared_ptr<Process>& process) {
     process->state = ProcessState::READY;
     {
         std::lock_guard<std::mutex> lock(processMutex);
         allProcesses.push_back(process);
-        readyQueue.push_back(process);
-        std::sort(readyQueue.begin(), readyQueue.end(), [](const std::shared_ptr<Process>& a, const std::shared_ptr<Process>& b) {
-            return a->arrivalTime < b->arrivalTime;
-        });
     }
-    processCV.notify_one();
-    return true;
+    makeReady(process);
 }
 
-bool Scheduler::createProcess(const std::string& name, size_t memorySize) {
-    ensureSchedulerStarted();
+// Called after a finished process has released its memory. Each round picks
+// one candidate under admissionMutex, allocates for it with the lock dropped,
+// and re-takes the lock only to pop it or hand it back. Under fifo a head
+// that another thread is already allocating for ends the round.
+void Scheduler::admitPending() {
+    bool bestFit = config->admissionOrder == "best-fit";
+    std::vector<std::shared_ptr<Process>> admitted;
+    std::vector<Process*> tried;
     
-    static std::mutex creationLock;
-    static int strictArrivalCounter = 0;
-    std::lock_guard<std::mutex> creationGuard(creationLock);
-    auto process = std::make_shared<Process>(name, memorySize);
-    process->arrivalTime = ++strictArrivalCounter;
+    while (true) {
+        std::shared_ptr<Process> candidate;
+        {
+            std::lock_guard<std::mutex> lock(admissionMutex);
+            PendingAdmission* pick = nullptr;
+            for (auto& pending : pendingAdmission) {
+                if (pending.claimed || std::find(tried.begin(), tried.end(), pending.process.get()) != tried.end()) {
+                    if (!bestFit) break;
+                    continue;
+                }
+                if (!pick || pending.process->allocatedMemory > pick->process->allocatedMemory) {
+                    pick = &pending;
+                }
+                if (!bestFit) break;
+            }
+            if (!pick) {
+                break;
+            }
+            pick->claimed = true;
+            candidate = pick->process;
+        }
+        
+        bool allocated = memoryManager->allocateMemory(candidate->pid, candidate->allocatedMemory);
+        
+        {
+            std::lock_guard<std::mutex> lock(admissionMutex);
+            auto it = std::find_if(pendingAdmission.begin(), pendingAdmission.end(), [&candidate](const PendingAdmission& pending) {
+                return pending.process == candidate;
+            });
+            if (allocated) {
+                int64_t waited = Clock::now() - it->queuedAt;
+                admissionWaitTotal += waited;
+                admissionWaitMax = std::max(admissionWaitMax, waited);
+                admittedFromQueue++;
+                pendingAdmission.erase(it);
+            } else {
+                it->claimed = false;
+            }
+        }
+        
+        if (allocated) {
+            admitted.push_back(candidate);
+        } else if (bestFit) {
+            tried.push_back(candidate.get());
+        } else {
+            break;
+        }
+    }
     
-    if (!memoryManager->allocateMemory(process->pid, memorySize)) {
-        std::cout << "Invalid memory allocation" << std::endl;
+    std::sort(admitted.begin(), admitted.end(), [](const std::shared_ptr<Process>& a, const std::shared_ptr<Process>& b) {
+        return a->arrivalTime < b->arrivalTime;
+    });
+    for (const auto& process : admitted) {
+        launch(process);
+    }
+}
+
+// Unfinished processes are written with their remaining program and variables;
+// their pages are flushed to the durable backing store so a later run can
+// fault them back in on demand. Processes still waiting for admission come
+// first, after a line holding the times they were queued at.
+bool Scheduler::saveCheckpoint() {
+    std::ofstream file(checkpointPath, std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Error: Cannot write checkpoint file: " << checkpointPath << std::endl;
         return false;
     }
     
-    int baseInstructionCount = Utils::generateRandomInt(
-        config->minInstructions, config->maxInstructions);
-    process->generateInstructions(baseInstructionCount);
-    process->state = ProcessState::READY;
+    memoryManager->checkpointPages();
+    
+    std::lock_guard<std::mutex> lock(processMutex);
+    file << "CSOPESY Checkpoint v1" << std::endl;
+    file << "COUNTERS " << processCounter.load() << " " << strictArrivalCounter << std::endl;
+    
+    // The timer lock keeps each sleeper's wake tick stable while it is saved.
+    std::lock_guard<std::mutex> timerLock(timerMutex);
+    uint64_t now = cpuTick.load();
+    int saved = 0;
     {
-        std::lock_guard<std::mutex> lock(processMutex);
-        allProcesses.push_back(process);
-        readyQueue.push_back(process);
-        std::sort(readyQueue.begin(), readyQueue.end(), [](const std::shared_ptr<Process>& a, const std::shared_ptr<Process>& b) {
-            return a->arrivalTime < b->arrivalTime;
-        });
+        std::lock_guard<std::mutex> admissionLock(admissionMutex);
+        if (!pendingAdmission.empty()) {
+            file << "ADMISSION_QUEUE";
+            for (const auto& pending : pendingAdmission) {
+                file << " " << pending.queuedAt;
+            }
+            file << std::endl;
+            for (const auto& pending : pendingAdmission) {
+                pending.process->writeCheckpoint(file, now);
+                saved++;
+            }
+        }
     }
-    processCV.notify_one();
+    for (const auto& process : allProcesses) {
+        if (process->state == ProcessState::TERMINATED || process->isComplete()) continue;
+        process->writeCheckpoint(file, now);
+        saved++;
+    }
+    
+    std::cout << "Checkpointed " << saved << " process(es) to " << checkpointPath << std::endl;
     return true;
 }
 
-bool Scheduler::createProcess(const std::string& name, size_t memorySize, const std::vector<std::string>& instructions) {
-    ensureSchedulerStarted();
+int Scheduler::loadCheckpoint() {
+    std::ifstream file(checkpointPath);
+    if (!file.is_open()) return 0;
     
-    if (instructions.size() < 1 || instructions.size() > 50) {
-        std::cout << "Invalid command" << std::endl;
-        return false;
+    std::string line;
+    if (!std::getline(file, line) || line != "CSOPESY Checkpoint v1") {
+        std::cerr << "Warning: " << checkpointPath << " is not a valid checkpoint." << std::endl;
+        return 0;
     }
     
-    static std::mutex creationLock;
-    static int strictArrivalCounter = 0;
-    std::lock_guard<std::mutex> creationGuard(creationLock);
-    auto process = std::make_shared<Process>(name, memorySize, instructions);
-    process->arrivalTime = ++strictArrivalCounter;
+    std::streampos afterHeader = file.tellg();
+    if (std::getline(file, line) && line.rfind("COUNTERS ", 0) == 0) {
+        std::istringstream counters(line.substr(9));
+        int savedProcessCounter = 1;
+        counters >> savedProcessCounter >> strictArrivalCounter;
+        processCounter.store(savedProcessCounter);
+    } else {
+        file.seekg(afterHeader);
+    }
     
-    if (!memoryManager->allocateMemory(process->pid, memorySize)) {
-        std::cout << "Invalid memory allocation" << std::endl;
-        return false;
+    std::streampos afterCounters = file.tellg();
+    std::vector<int64_t> queuedAt;
+    if (std::getline(file, line) && line.rfind("ADMISSION_QUEUE", 0) == 0) {
+        std::istringstream times(line.substr(15));
+        for (int64_t time; times >> time; ) {
+            queuedAt.push_back(time);
+        }
+    } else {
+        file.clear();
+        file.seekg(afterCounters);
     }
     
-    process->state = ProcessState::READY;
+    std::deque<PendingAdmission> pending;
+    for (int64_t time : queuedAt) {
+        auto process = Process::readCheckpoint(file);
+        if (!process) break;
+        process->state = ProcessState::NEW;
+        pending.push_back(PendingAdmission{process, time});
+    }
+    
+    std::vector<std::shared_ptr<Process>> restored;
+    while (auto process = Process::readCheckpoint(file)) {
+        if (!memoryManager->restoreMemory(process->pid, process->allocatedMemory)) {
+            std::cerr << "Warning: could not restore memory for " << process->name << std::endl;
+            continue;
+        }
+        restored.push_back(process);
+    }
+    file.close();
+    
+    std::sort(restored.begin(), restored.end(), [](const std::shared_ptr<Process>& a, const std::shared_ptr<Process>& b) {
+        return a->arrivalTime < b->arrivalTime;
+    });
+    
     {
         std::lock_guard<std::mutex> lock(processMutex);
-        allProcesses.push_back(process);
-        readyQueue.push_back(process);
-        std::sort(readyQueue.begin(), readyQueue.end(), [](const std::shared_ptr<Process>& a, const std::shared_ptr<Process>& b) {
-            return a->arrivalTime < b->arrivalTime;
-        });
+        for (const auto& process : restored) {
+            allProcesses.push_back(process);
+        }
     }
-    processCV.notify_one();
-    return true;
+    for (const auto& process : restored) {
+        if (process->sleepRemaining > 0) {
+            addSleeper(process);
+        } else {
+            makeReady(process);
+        }
+    }
+    
+    size_t queued = pending.size();
+    if (queued > 0) {
+        {
+            std::lock_guard<std::mutex> lock(admissionMutex);
+            pendingAdmission.swap(pending);
+        }
+        admitPending();
+    }
+    
+    std::remove(checkpointPath.c_str());
+    return static_cast<int>(restored.size() + queued);
 }
 
 void Scheduler::displaySystemStatus() const {
@@ -475,6 +1072,73 @@ void Scheduler::displaySystemStatus() const {
     std::cout << "Running processes:" << std::endl;
 }
 
+// Averages over finished processes, in wall-clock milliseconds.
+static void writeAverages(std::ostream& out, const std::string& policy, const std::vector<ProcessSummary>& finished) {
+    double waiting = 0.0, turnaround = 0.0, response = 0.0;
+    for (const auto& p : finished) {
+        waiting += p.waitingTime;
+        turnaround += p.turnaroundTime;
+        response += std::max(0, p.responseTime);
+    }
+    
+    double count = static_cast<double>(finished.size());
+    out << std::fixed << std::setprecision(0)
+        << "Averages (" << policy << ", " << finished.size() << " finished): waiting " << waiting / count
+        << " ms, turnaround " << turnaround / count << " ms, response " << response / count << " ms" << std::endl;
+    out.unsetf(std::ios::fixed);
+}
+
+static void writeMigrations(std::ostream& out, uint64_t dispatches, uint64_t migrations) {
+    double rate = dispatches == 0 ? 0.0 : 100.0 * migrations / dispatches;
+    out << "Migrations: " << migrations << " of " << dispatches << " dispatches ("
+        << std::fixed << std::setprecision(1) << rate << "%)" << std::endl;
+    out.unsetf(std::ios::fixed);
+}
+
+void Scheduler::writeSwitches(std::ostream& out) const {
+    uint64_t dispatches = totalDispatches.load();
+    double seconds = Clock::ticks() / 1000.0;
+    out << std::fixed << std::setprecision(1)
+        << "Context switches: " << dispatches << " (" << (seconds > 0 ? dispatches / seconds : 0.0) << "/s";
+    if (adaptiveQuantum) {
+        out << ", last second " << switchRate.load() << "/s, target " << config->quantumTarget
+            << "/s, quantum scale " << quantumScale.load() / 100.0 << "x";
+    }
+    out << ")" << std::endl;
+    
+    if (config->scheduler == "rr") {
+        uint64_t slices = quantumSlices.load();
+        out << "Quantum distribution:";
+        for (int bucket = 0; bucket < QUANTUM_BUCKETS; ++bucket) {
+            uint64_t count = quantumHistogram[bucket].load();
+            if (count == 0) {
+                continue;
+            }
+            int low = 1 << bucket;
+            int high = (2 << bucket) - 1;
+            out << " " << low;
+            if (bucket == QUANTUM_BUCKETS - 1) {
+                out << "+";
+            } else if (high > low) {
+                out << "-" << high;
+            }
+            out << " " << 100.0 * count / slices << "%";
+        }
+        out << " (" << slices << " slices, mean " << (slices ? static_cast<double>(quantumGranted.load()) / slices : 0.0)
+            << " cycles)" << std::endl;
+    }
+    out.unsetf(std::ios::fixed);
+}
+
+void Scheduler::writeAdmissions(std::ostream& out) const {
+    std::lock_guard<std::mutex> lock(admissionMutex);
+    int64_t oldest = pendingAdmission.empty() ? 0 : Clock::now() - pendingAdmission.front().queuedAt;
+    int64_t average = admittedFromQueue == 0 ? 0 : admissionWaitTotal / static_cast<int64_t>(admittedFromQueue);
+    out << "Admission queue: " << pendingAdmission.size() << " / " << config->admissionLimit << " waiting"
+        << " (oldest " << oldest << " ms), " << admittedFromQueue << " admitted after avg " << average
+        << " ms (max " << admissionWaitMax << " ms), " << admissionRejected << " rejected" << std::endl;
+}
+
 void Scheduler::displayProcesses() const {
     std::lock_guard<std::mutex> lock(processMutex);
     
@@ -483,7 +1147,7 @@ void Scheduler::displayProcesses() const {
         if (runningProcesses[i]) {
             auto& p = runningProcesses[i];
             std::cout << std::left << std::setw(12) << p->name << "  ";
-            std::cout << "(Started: " << p->creationTimestamp << ")  ";
+            std::cout << "(Started: " << Clock::format(p->creationTimestamp) << ")  ";
             std::cout << "Core: " << i << "  ";
             std::cout << p->executedInstructions << " / " << p->totalInstructions << std::endl;
             hasRunningProcesses = true;
@@ -495,16 +1159,22 @@ void Scheduler::displayProcesses() const {
     }
     
     std::cout << std::endl << "Finished processes:" << std::endl;
-    if (terminatedProcesses.empty()) {
+    std::vector<ProcessSummary> finished = archive.summaries();
+    if (finished.empty()) {
         std::cout << "No processes have finished yet." << std::endl;
     } else {
-        for (const auto& p : terminatedProcesses) {
-            std::cout << std::left << std::setw(12) << p->name << "  ";
-            std::cout << "(" << p->completionTimestamp << ")  ";
+        for (const auto& p : finished) {
+            std::cout << std::left << std::setw(12) << p.name << "  ";
+            std::cout << "(" << Clock::format(p.completionTimestamp) << ")  ";
             std::cout << "Finished  ";
-            std::cout << p->executedInstructions << " / " << p->totalInstructions << std::endl;
+            std::cout << p.executedInstructions << " / " << p.totalInstructions << std::endl;
         }
+        std::cout << std::endl;
+        writeAverages(std::cout, config->scheduler, finished);
     }
+    writeMigrations(std::cout, totalDispatches.load(), totalMigrations.load());
+    writeSwitches(std::cout);
+    writeAdmissions(std::cout);
     std::cout << "---------------------------------------------" << std::endl;
 }
 
@@ -548,7 +1218,7 @@ void Scheduler::generateReport(const std::string& filename) const {
         if (runningProcesses[i]) {
             auto& p = runningProcesses[i];
             file << std::left << std::setw(12) << p->name << "  ";
-            file << "(Started: " << p->creationTimestamp << ")  ";
+            file << "(Started: " << Clock::format(p->creationTimestamp) << ")  ";
             file << "Core: " << i << "  ";
             file << p->executedInstructions << " / " << p->totalInstructions << std::endl;
             hasRunningProcesses = true;
@@ -560,16 +1230,22 @@ void Scheduler::generateReport(const std::string& filename) const {
     }
     
     file << "\nFinished processes:" << std::endl;
-    if (terminatedProcesses.empty()) {
+    std::vector<ProcessSummary> finished = archive.summaries();
+    if (finished.empty()) {
         file << "No processes have finished yet." << std::endl;
     } else {
-        for (const auto& p : terminatedProcesses) {
-            file << std::left << std::setw(12) << p->name << "  ";
-            file << "(" << p->completionTimestamp << ")  ";
+        for (const auto& p : finished) {
+            file << std::left << std::setw(12) << p.name << "  ";
+            file << "(" << Clock::format(p.completionTimestamp) << ")  ";
             file << "Finished  ";
-            file << p->executedInstructions << " / " << p->totalInstructions << std::endl;
+            file << p.executedInstructions << " / " << p.totalInstructions << std::endl;
         }
+        file << std::endl;
+        writeAverages(file, config->scheduler, finished);
     }
+    writeMigrations(file, totalDispatches.load(), totalMigrations.load());
+    writeSwitches(file);
+    writeAdmissions(file);
     file << "---------------------------------------------" << std::endl;
     
     file.close();
@@ -584,6 +1260,13 @@ std::shared_ptr<Process> Scheduler::findProcess(const std::string& name) const {
             return process;
         }
     }
+    
+    std::lock_guard<std::mutex> admissionLock(admissionMutex);
+    for (const auto& pending : pendingAdmission) {
+        if (pending.process->name == name || pending.process->pid == name) {
+            return pending.process;
+        }
+    }
     return nullptr;
 }
 
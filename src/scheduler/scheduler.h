@@ -3,10 +3,21 @@
 
 #include "../config/config.h"
 #include "../process/process.h"
+#include "../process/process_archive.h"
 #include "../memory/memory_manager.h"
+#include "../utils/random.h"
+#include "work_stealing_deque.h"
+#include "mpmc_queue.h"
+#include "timer_wheel.h"
+#include "level_queue.h"
+#include "indexed_heap.h"
 #include <memory>
 #include <vector>
+#include <map>
+#include <string>
+#include <utility>
 #include <queue>
+#include <deque>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
@@ -19,9 +30,95 @@ private:
     std::unique_ptr<MemoryManager> memoryManager;
 
     std::vector<std::shared_ptr<Process>> allProcesses;
-    std::vector<std::shared_ptr<Process>> readyQueue;
+    std::map<std::pair<int, std::string>, std::shared_ptr<Process>> readyQueue;
     std::vector<std::shared_ptr<Process>> runningProcesses;
-    std::vector<std::shared_ptr<Process>> terminatedProcesses;
+    
+    // FCFS keeps the single global readyQueue, keyed by the arrival ticket
+    // handed out at creation, so an idle core always dispatches the earliest
+    // arrival no matter in which order processes were queued. The pid breaks
+    // ties so two processes sharing a ticket both stay queued. Round robin
+    // uses either per-core run queues or one shared lock-free ring
+    // (ready-queue "mpmc"). MLFQ and strict priority share a LevelQueue
+    // indexed by Process::priority, which under MLFQ is the process's
+    // current level.
+    //
+    // With per-core queues only the core itself pushes onto its deque;
+    // processes made ready by other threads go to the core's inbox and are
+    // moved over the next time the core dispatches. An idle core steals from
+    // the most loaded queue.
+    enum class ReadyQueueMode { GLOBAL, PER_CORE, MPMC, LEVELED, SHORTEST };
+    ReadyQueueMode queueMode = ReadyQueueMode::GLOBAL;
+    MpmcQueue<Process*> sharedReadyQueue{65536};
+    LevelQueue<std::shared_ptr<Process>> levelQueue;
+    std::atomic<uint64_t> nextBoostTick{0};
+    
+    // SJF and SRTF queue ready processes by remaining instructions. SRTF also
+    // keeps the busy cores keyed by what their process has left, longest on
+    // top, so an arrival only compares against one core to decide whether it
+    // preempts.
+    IndexedHeap<Process*> shortestQueue;
+    IndexedHeap<int, std::greater<int64_t>> runningByRemaining;
+    std::unique_ptr<std::atomic<bool>[]> preemptRequested;
+    
+    // Round robin with per-core queues sends a process that left its core
+    // less than affinity-window ticks ago back to that core. An idle core
+    // only steals a victim's last queued process once it has itself been
+    // idle for longer than the window.
+    std::vector<uint64_t> idleSince;
+    
+    // Processes that could not get memory wait here, up to admission-limit,
+    // and are admitted as completions free memory: from the head only
+    // ("fifo") or whichever fit, largest first ("best-fit"). Memory is
+    // allocated outside admissionMutex; claimed marks the entry one thread
+    // is allocating for so no other thread tries it at the same time.
+    struct PendingAdmission {
+        std::shared_ptr<Process> process;
+        int64_t queuedAt;
+        bool claimed = false;
+    };
+    mutable std::mutex admissionMutex;
+    std::deque<PendingAdmission> pendingAdmission;
+    uint64_t admittedFromQueue = 0;
+    uint64_t admissionRejected = 0;
+    int64_t admissionWaitTotal = 0;
+    int64_t admissionWaitMax = 0;
+    std::atomic<uint64_t> totalDispatches{0};
+    std::atomic<uint64_t> totalMigrations{0};
+    
+    // Adaptive round robin (quantum-target > 0). Each process carries its own
+    // quantum: halfway towards the run length at which it last slept or took
+    // a major fault, doubled when it used a whole slice without either. Once
+    // a second the context switch rate is compared with the target and one
+    // scale, in percent, applied to every quantum is raised or lowered.
+    static const int QUANTUM_BUCKETS = 8;
+    bool adaptiveQuantum = false;
+    std::atomic<int> quantumScale{100};
+    std::atomic<int64_t> nextTuneAt{0};
+    std::atomic<int64_t> lastTuneAt{0};
+    std::atomic<uint64_t> tuneDispatches{0};
+    std::atomic<double> switchRate{0.0};
+    std::atomic<uint64_t> quantumHistogram[QUANTUM_BUCKETS] = {};
+    std::atomic<uint64_t> quantumSlices{0};
+    std::atomic<uint64_t> quantumGranted{0};
+    
+    struct CoreQueue {
+        WorkStealingDeque<Process*> local;
+        std::mutex inboxMutex;
+        std::deque<Process*> inbox;
+        std::atomic<size_t> inboxSize{0};
+        
+        size_t load() const { return local.size() + inboxSize.load(std::memory_order_relaxed); }
+    };
+    std::vector<std::unique_ptr<CoreQueue>> coreQueues;
+    ProcessArchive archive{"csopesy-archive.log"};
+    
+    // A process that runs SLEEP leaves its core and waits in the timer wheel
+    // until cpuTick, which every core advances once per instruction or idle
+    // wait, reaches its wake-up tick.
+    std::atomic<uint64_t> cpuTick{0};
+    std::mutex timerMutex;
+    TimerWheel<Process*> sleepers;
+    std::atomic<size_t> sleeperCount{0};
     
     std::vector<std::thread> coreWorkers;
     std::atomic<bool> isRunning{false};
@@ -31,6 +128,10 @@ private:
     std::condition_variable processCV;
     
     std::atomic<int> processCounter{1};
+    std::mutex creationMutex;
+    int strictArrivalCounter = 0;
+    Xoshiro256 workloadRandom;
+    std::string checkpointPath = "csopesy-checkpoint.txt";
     std::chrono::high_resolution_clock::time_point systemStartTime;
     
     std::vector<int> coreQuantumCounters;
@@ -39,6 +140,27 @@ private:
     void processCreatorThread();
     void testModeProcessCreator();
     void handleProcessCompletion(std::shared_ptr<Process> process);
+    void assignToCore(int coreId, const std::shared_ptr<Process>& process);
+    void releaseCore(int coreId);
+    void preempt(int coreId, const std::shared_ptr<Process>& process);
+    void makeReady(const std::shared_ptr<Process>& process, int coreId = -1);
+    std::shared_ptr<Process> takeReady(int coreId);
+    size_t readyCount() const;
+    bool isWarm(const Process& process) const;
+    bool submit(const std::shared_ptr<Process>& process, const std::vector<size_t>& sizes, bool announce);
+    void admitPending();
+    void launch(const std::shared_ptr<Process>& process);
+    void writeAdmissions(std::ostream& out) const;
+    void addSleeper(const std::shared_ptr<Process>& process);
+    void wakeSleepers();
+    void boostPriorities();
+    int quantumFor(const Process& process) const;
+    void endSlice(Process& process, int ran, bool slept);
+    void tuneQuantumScale();
+    void writeSwitches(std::ostream& out) const;
+    int startingLevel(bool batch) const;
+    bool saveCheckpoint();
+    int loadCheckpoint();
     
 public:
     Scheduler(std::unique_ptr<SystemConfig> cfg);
@@ -63,6 +185,7 @@ public:
     MemoryManager* getMemoryManager() const { return memoryManager.get(); }
     const SystemConfig* getConfig() const { return config.get(); }
     const std::vector<std::shared_ptr<Process>>& getRunningProcesses() const { return runningProcesses; }
+    const ProcessArchive& getArchive() const { return archive; }
 };
 
 #endif
@@ -0,0 +1,303 @@
+#include "simulation.h"
+#include "../utils/utils.h"
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+Simulation::Simulation(const SystemConfig& config, size_t processCount)
+    : config(config), processCount(processCount) {
+    stepTicks = 1 + static_cast<uint64_t>(std::max(0, config.delayPerExec));
+    cores.resize(std::max(1, config.numCpu));
+    random.seed(Utils::deriveSeed("simulation"));
+    readyAtLevel.resize(std::max(1, config.priorityLevels), 0);
+    nextBoost = static_cast<uint64_t>(config.boostInterval);
+
+    for (size_t size = config.minMemoryPerProcess; size <= config.maxMemoryPerProcess && size > 0; size *= 2) {
+        memorySizes.push_back(size);
+    }
+    if (memorySizes.empty()) {
+        memorySizes.push_back(std::max<size_t>(config.minMemoryPerProcess, 64));
+    }
+}
+
+Simulation::~Simulation() {
+    SimProcess* process = nullptr;
+    while (shortestReady.pop(process)) {
+        delete process;
+    }
+}
+
+SimulationResult Simulation::run(uint64_t maxTicks) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    if (processCount > 0) {
+        schedule(0, EventType::ARRIVAL);
+    }
+
+    while (!events.empty()) {
+        Event event = events.top();
+        if (event.tick > maxTicks) {
+            break;
+        }
+        events.pop();
+        now = event.tick;
+        boostLevels();
+
+        if (event.type == EventType::ARRIVAL) {
+            arrive();
+        } else if (event.type == EventType::WAKE) {
+            wake(event.core);
+        } else {
+            stepCore(event.core);
+        }
+    }
+
+    result.ticks = now;
+    if (result.completed > 0) {
+        result.averageWaiting = waitingSum / result.completed;
+        result.averageTurnaround = turnaroundSum / result.completed;
+        result.averageResponse = responseSum / result.completed;
+    }
+    result.wallMillis = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - start).count();
+    return result;
+}
+
+void Simulation::schedule(uint64_t tick, EventType type, int core) {
+    events.push(Event{tick, sequence++, type, core});
+    if (type == EventType::CORE) {
+        cores[core].scheduled = true;
+    }
+}
+
+void Simulation::wakeIdleCores() {
+    for (size_t core = 0; core < cores.size() && hasReady(); ++core) {
+        if (!cores[core].current && !cores[core].scheduled) {
+            schedule(now, EventType::CORE, static_cast<int>(core));
+        }
+    }
+}
+
+void Simulation::arrive() {
+    created++;
+    size_t memorySize = memorySizes[random.range(0, static_cast<int>(memorySizes.size()) - 1)];
+    auto process = std::make_shared<Process>("sim" + std::to_string(created), memorySize);
+    process->generateInstructions(random.range(config.minInstructions, config.maxInstructions));
+    process->arrivalTime = static_cast<int>(created);
+    process->priority = config.scheduler == "priority" ? config.priorityLevels - 1 : 0;
+
+    auto entry = std::make_unique<SimProcess>();
+    entry->process = process;
+    entry->arrivalTick = now;
+    int remaining = process->remainingTime;
+    makeReady(std::move(entry));
+    if (config.scheduler == "srtf") {
+        preemptLongest(remaining);
+    }
+
+    if (created < processCount) {
+        schedule(now + std::max(1, config.batchProcessFreq), EventType::ARRIVAL);
+    }
+    wakeIdleCores();
+}
+
+void Simulation::makeReady(std::unique_ptr<SimProcess> process) {
+    process->readySince = now;
+    process->process->state = ProcessState::READY;
+    process->process->coreAssignment = -1;
+    if (leveled()) {
+        readyAtLevel[process->process->priority]++;
+    }
+    if (shortestFirst()) {
+        int64_t key = process->process->shortestFirstKey();
+        shortestReady.push(process.release(), key);
+        return;
+    }
+    readyQueue.push_back(std::move(process));
+}
+
+// SRTF: a new arrival shorter than the longest running process takes its core
+// at that core's next step. An idle core picks the arrival up instead.
+void Simulation::preemptLongest(int remaining) {
+    Core* longest = nullptr;
+    for (auto& core : cores) {
+        if (!core.current) {
+            return;
+        }
+        if (!core.releasing &&
+            (!longest || core.current->process->remainingTime > longest->current->process->remainingTime)) {
+            longest = &core;
+        }
+    }
+    if (longest && remaining < longest->current->process->remainingTime) {
+        longest->releasing = true;
+    }
+}
+
+bool Simulation::leveled() const {
+    return config.scheduler == "mlfq" || config.scheduler == "priority";
+}
+
+bool Simulation::shortestFirst() const {
+    return config.scheduler == "sjf" || config.scheduler == "srtf";
+}
+
+bool Simulation::hasReady() const {
+    return !readyQueue.empty() || !shortestReady.empty();
+}
+
+int Simulation::highestReadyLevel() const {
+    for (size_t level = 0; level < readyAtLevel.size(); ++level) {
+        if (readyAtLevel[level] > 0) {
+            return static_cast<int>(level);
+        }
+    }
+    return static_cast<int>(readyAtLevel.size());
+}
+
+void Simulation::boostLevels() {
+    if (config.scheduler != "mlfq" || config.boostInterval == 0 || now < nextBoost) {
+        return;
+    }
+    nextBoost = now + config.boostInterval;
+
+    for (auto& process : readyQueue) {
+        process->process->priority = 0;
+    }
+    for (auto& core : cores) {
+        if (core.current) core.current->process->priority = 0;
+    }
+    for (auto& process : sleepers) {
+        if (process) process->process->priority = 0;
+    }
+    std::fill(readyAtLevel.begin(), readyAtLevel.end(), 0);
+    readyAtLevel[0] = readyQueue.size();
+}
+
+std::unique_ptr<Simulation::SimProcess> Simulation::pickNext() {
+    if (shortestFirst()) {
+        SimProcess* shortest = nullptr;
+        return shortestReady.pop(shortest) ? std::unique_ptr<SimProcess>(shortest) : nullptr;
+    }
+    if (readyQueue.empty()) {
+        return nullptr;
+    }
+
+    auto it = readyQueue.begin();
+    if (config.scheduler == "fcfs") {
+        it = std::min_element(readyQueue.begin(), readyQueue.end(),
+            [](const std::unique_ptr<SimProcess>& a, const std::unique_ptr<SimProcess>& b) {
+                return a->arrivalTick < b->arrivalTick;
+            });
+    } else if (leveled()) {
+        int level = highestReadyLevel();
+        it = std::find_if(readyQueue.begin(), readyQueue.end(),
+            [level](const std::unique_ptr<SimProcess>& process) {
+                return process->process->priority == level;
+            });
+        readyAtLevel[level]--;
+    }
+
+    std::unique_ptr<SimProcess> next = std::move(*it);
+    readyQueue.erase(it);
+    return next;
+}
+
+// A core event either runs one instruction of the core's process or, when the
+// previous event left the process out of quantum, first puts it back in the
+// ready queue and dispatches the next one.
+void Simulation::stepCore(int coreId) {
+    Core& core = cores[coreId];
+    // Counts as scheduled while it runs, so releasing a process does not queue
+    // a second event for this core.
+    core.scheduled = true;
+
+    if (core.current && core.releasing) {
+        core.releasing = false;
+        makeReady(std::move(core.current));
+        wakeIdleCores();
+    }
+
+    if (!core.current) {
+        core.current = pickNext();
+        if (!core.current) {
+            core.scheduled = false;
+            return;
+        }
+
+        core.current->waitingTicks += now - core.current->readySince;
+        if (!core.current->started) {
+            core.current->started = true;
+            responseSum += static_cast<double>(now - core.current->arrivalTick);
+        }
+        core.quantumUsed = 0;
+        core.releasing = false;
+        core.current->process->state = ProcessState::RUNNING;
+        core.current->process->coreAssignment = coreId;
+        result.contextSwitches++;
+    }
+
+    Process& process = *core.current->process;
+    int steps = process.run(1, false);
+    uint64_t next = now + stepTicks;
+    result.instructions += steps;
+    result.busyTicks += stepTicks;
+
+    if (process.isComplete() || (steps == 0 && !process.hasMoreInstructions())) {
+        complete(std::move(core.current), next);
+        schedule(next, EventType::CORE, coreId);
+        return;
+    }
+
+    if (process.state == ProcessState::WAITING && process.sleepRemaining > 0) {
+        sleep(std::move(core.current), next + process.sleepRemaining);
+        schedule(next, EventType::CORE, coreId);
+        return;
+    }
+
+    if (config.scheduler == "rr" || leveled()) {
+        int level = process.priority;
+        int quantum = config.scheduler == "mlfq" ? config.quantumForLevel(level) : config.quantumCycles;
+        bool preempted = leveled() && highestReadyLevel() < level;
+        bool expired = ++core.quantumUsed >= quantum;
+        if (config.scheduler == "priority" && highestReadyLevel() > level) {
+            expired = false;
+        }
+
+        if (expired && config.scheduler == "mlfq" && level < config.priorityLevels - 1) {
+            process.priority = level + 1;
+        }
+        core.releasing = preempted || expired;
+    }
+    schedule(next, EventType::CORE, coreId);
+}
+
+void Simulation::sleep(std::unique_ptr<SimProcess> process, uint64_t wakeTick) {
+    int slot;
+    if (freeSleeperSlots.empty()) {
+        slot = static_cast<int>(sleepers.size());
+        sleepers.push_back(nullptr);
+    } else {
+        slot = freeSleeperSlots.back();
+        freeSleeperSlots.pop_back();
+    }
+    sleepers[slot] = std::move(process);
+    schedule(wakeTick, EventType::WAKE, slot);
+}
+
+void Simulation::wake(int slot) {
+    std::unique_ptr<SimProcess> process = std::move(sleepers[slot]);
+    freeSleeperSlots.push_back(slot);
+    process->process->sleepRemaining = 0;
+    makeReady(std::move(process));
+    wakeIdleCores();
+}
+
+void Simulation::complete(std::unique_ptr<SimProcess> process, uint64_t tick) {
+    process->process->state = ProcessState::TERMINATED;
+    process->process->waitingTime = static_cast<int>(process->waitingTicks);
+    process->process->turnaroundTime = static_cast<int>(tick - process->arrivalTick);
+    waitingSum += process->process->waitingTime;
+    turnaroundSum += process->process->turnaroundTime;
+    result.completed++;
+}
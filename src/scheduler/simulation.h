@@ -0,0 +1,114 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include "../config/config.h"
+#include "../process/process.h"
+#include "../utils/random.h"
+#include "indexed_heap.h"
+#include <memory>
+#include <vector>
+#include <deque>
+#include <queue>
+#include <cstdint>
+
+struct SimulationResult {
+    uint64_t ticks = 0;
+    uint64_t busyTicks = 0;
+    uint64_t instructions = 0;
+    uint64_t contextSwitches = 0;
+    size_t completed = 0;
+    double averageWaiting = 0.0;
+    double averageTurnaround = 0.0;
+    double averageResponse = 0.0;
+    double wallMillis = 0.0;
+};
+
+// Fast-forward run of the scheduler on a virtual timeline measured in CPU
+// ticks. Core steps, sleep expiries and process arrivals are events in a
+// queue ordered by tick, so the clock jumps straight to the next event and
+// nothing waits on the wall clock. One instruction takes 1 + delay-per-exec
+// ticks, a new process arrives every batch-process-freq ticks, and cores pick
+// work with the configured policy and quantum. A sleeping process leaves its
+// core and is made ready again by a wake event. Under MLFQ and priority the
+// level of a process is its Process::priority, as in the scheduler.
+class Simulation {
+public:
+    Simulation(const SystemConfig& config, size_t processCount);
+    ~Simulation();
+
+    Simulation(const Simulation&) = delete;
+    Simulation& operator=(const Simulation&) = delete;
+
+    SimulationResult run(uint64_t maxTicks = UINT64_MAX);
+
+private:
+    enum class EventType { ARRIVAL, CORE, WAKE };
+
+    struct Event {
+        uint64_t tick;
+        uint64_t sequence;
+        EventType type;
+        int core;  // sleeper slot for WAKE events
+
+        bool operator>(const Event& other) const {
+            return tick != other.tick ? tick > other.tick : sequence > other.sequence;
+        }
+    };
+
+    struct SimProcess {
+        std::shared_ptr<Process> process;
+        uint64_t arrivalTick = 0;
+        uint64_t readySince = 0;
+        uint64_t waitingTicks = 0;
+        bool started = false;
+    };
+
+    struct Core {
+        std::unique_ptr<SimProcess> current;
+        int quantumUsed = 0;
+        bool scheduled = false;
+        bool releasing = false;
+    };
+
+    SystemConfig config;
+    size_t processCount;
+    size_t created = 0;
+    uint64_t now = 0;
+    uint64_t sequence = 0;
+    uint64_t stepTicks = 1;
+    Xoshiro256 random;
+    std::vector<size_t> memorySizes;
+
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events;
+    std::deque<std::unique_ptr<SimProcess>> readyQueue;
+    // SJF and SRTF order ready processes in the same IndexedHeap and by the
+    // same key as the scheduler. The heap owns the processes it holds.
+    IndexedHeap<SimProcess*> shortestReady;
+    std::vector<Core> cores;
+    std::vector<std::unique_ptr<SimProcess>> sleepers;
+    std::vector<int> freeSleeperSlots;
+    std::vector<size_t> readyAtLevel;
+    uint64_t nextBoost = 0;
+    SimulationResult result;
+    double waitingSum = 0.0;
+    double turnaroundSum = 0.0;
+    double responseSum = 0.0;
+
+    void schedule(uint64_t tick, EventType type, int core = -1);
+    void wakeIdleCores();
+    void arrive();
+    void stepCore(int coreId);
+    void sleep(std::unique_ptr<SimProcess> process, uint64_t wakeTick);
+    void wake(int slot);
+    void makeReady(std::unique_ptr<SimProcess> process);
+    std::unique_ptr<SimProcess> pickNext();
+    void complete(std::unique_ptr<SimProcess> process, uint64_t tick);
+    void preemptLongest(int remaining);
+    bool leveled() const;
+    bool shortestFirst() const;
+    bool hasReady() const;
+    int highestReadyLevel() const;
+    void boostLevels();
+};
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Hierarchical timing wheel over an integer tick. Level 0 has one slot per
+// tick for the next 64 ticks, each higher level covers 64 times the span of
+// the one below. A timer is filed in the lowest level that reaches its
+// expiry and is moved down a level when the wheel turns onto its slot, so
+// adding a timer is O(1) whatever its length and every tick only touches
+// the slots that are due. Expiries beyond the top level wait in an overflow
+// list that is refiled once per full turn.
+template <typename T>
+class TimerWheel {
+public:
+    explicit TimerWheel(uint64_t start = 0) : current(start) {}
+
+    uint64_t now() const { return current; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    // A timer that is already due fires on the next advance().
+    void schedule(T item, uint64_t expiry) {
+        file(Timer{expiry > current ? expiry : current + 1, item});
+        count++;
+    }
+
+    // Moves the wheel forward to tick `target` and appends every timer that
+    // expired on the way to `expired`.
+    void advance(uint64_t target, std::vector<T>& expired) {
+        if (count == 0) {
+            current = target > current ? target : current;
+            return;
+        }
+
+        while (current < target) {
+            current++;
+            cascade();
+
+            std::vector<Timer>& slot = slots[0][current & SLOT_MASK];
+            for (const Timer& timer : slot) {
+                expired.push_back(timer.item);
+            }
+            count -= slot.size();
+            slot.clear();
+
+            if (count == 0) {
+                current = target;
+            }
+        }
+    }
+
+private:
+    static const int SLOT_BITS = 6;
+    static const uint64_t SLOTS = 1ull << SLOT_BITS;
+    static const uint64_t SLOT_MASK = SLOTS - 1;
+    static const int LEVELS = 4;
+
+    struct Timer {
+        uint64_t expiry;
+        T item;
+    };
+
+    std::vector<Timer> slots[LEVELS][SLOTS];
+    std::vector<Timer> overflow;
+    uint64_t current;
+    size_t count = 0;
+
+    void file(const Timer& timer) {
+        uint64_t delta = timer.expiry - current;
+        for (int level = 0; level < LEVELS; ++level) {
+            if (delta < (SLOTS << (SLOT_BITS * level))) {
+                slots[level][(timer.expiry >> (SLOT_BITS * level)) & SLOT_MASK].push_back(timer);
+                return;
+            }
+        }
+        overflow.push_back(timer);
+    }
+
+    // When a level wraps to slot 0 the slot of the level above is due; refile
+    // its timers from the top down so they land in the level 0 slots they
+    // expire in.
+    void cascade() {
+        int level = 0;
+        while (level < LEVELS && ((current >> (SLOT_BITS * level)) & SLOT_MASK) == 0) {
+            level++;
+        }
+
+        if (level == LEVELS) {
+            std::vector<Timer> pending;
+            pending.swap(overflow);
+            for (const Timer& timer : pending) {
+                file(timer);
+            }
+        }
+
+        for (int upper = (level < LEVELS ? level : LEVELS - 1); upper > 0; --upper) {
+            std::vector<Timer> pending;
+            pending.swap(slots[upper][(current >> (SLOT_BITS * upper)) & SLOT_MASK]);
+            for (const Timer& timer : pending) {
+                file(timer);
+            }
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef WORK_STEALING_DEQUE_H
+#define WORK_STEALING_DEQUE_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+// Chase-Lev deque of pointers. Only the owning thread pushes, at the bottom;
+// any thread, the owner included, takes from the top with a compare-and-swap
+// on `top`. Taking from the top keeps each queue FIFO, which round robin
+// needs. The ring doubles when full; retired rings are kept until the deque is
+// destroyed because a concurrent take may still be reading one.
+template <typename T>
+class WorkStealingDeque {
+public:
+    explicit WorkStealingDeque(size_t capacity = 64) {
+        size_t rounded = 1;
+        while (rounded < capacity) rounded <<= 1;
+        rings.emplace_back(new Ring(rounded));
+        ring.store(rings.back().get());
+    }
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    void push(T item) {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_acquire);
+        Ring* current = ring.load(std::memory_order_relaxed);
+
+        if (b - t >= static_cast<int64_t>(current->capacity)) {
+            current = grow(current, t, b);
+        }
+
+        current->put(b, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    bool take(T& item) {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_acquire);
+
+        if (t >= b) {
+            return false;
+        }
+
+        item = ring.load(std::memory_order_consume)->get(t);
+        return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+    size_t size() const {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_relaxed);
+        return b > t ? static_cast<size_t>(b - t) : 0;
+    }
+
+private:
+    struct Ring {
+        size_t capacity;
+        std::unique_ptr<std::atomic<T>[]> slots;
+
+        explicit Ring(size_t capacity) : capacity(capacity), slots(new std::atomic<T>[capacity]) {}
+
+        T get(int64_t index) const {
+            return slots[static_cast<size_t>(index) & (capacity - 1)].load(std::memory_order_relaxed);
+        }
+
+        void put(int64_t index, T item) {
+            slots[static_cast<size_t>(index) & (capacity - 1)].store(item, std::memory_order_relaxed);
+        }
+    };
+
+    alignas(64) std::atomic<int64_t> top{0};
+    alignas(64) std::atomic<int64_t> bottom{0};
+    std::atomic<Ring*> ring{nullptr};
+    std::vector<std::unique_ptr<Ring>> rings;
+
+    Ring* grow(Ring* current, int64_t t, int64_t b) {
+        rings.emplace_back(new Ring(current->capacity * 2));
+        Ring* larger = rings.back().get();
+        for (int64_t i = t; i < b; ++i) {
+            larger->put(i, current->get(i));
+        }
+        ring.store(larger, std::memory_order_release);
+        return larger;
+    }
+};
+
+#endif
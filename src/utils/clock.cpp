@@ -0,0 +1,95 @@
+#include "clock.h"
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <mutex>
+#include <thread>
+
+namespace {
+    std::mutex tickerMutex;
+    std::thread ticker;
+    std::atomic<bool> tickerRunning{false};
+    std::atomic<int64_t> cachedNow{0};
+    std::atomic<uint64_t> cachedTicks{0};
+    
+    std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+    int64_t originEpochMillis = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    
+    uint64_t elapsedMillis() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - origin).count();
+    }
+    
+    void refresh() {
+        uint64_t elapsed = elapsedMillis();
+        cachedTicks.store(elapsed, std::memory_order_relaxed);
+        cachedNow.store(originEpochMillis + static_cast<int64_t>(elapsed), std::memory_order_relaxed);
+    }
+    
+    void tick() {
+        while (tickerRunning.load(std::memory_order_relaxed)) {
+            refresh();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+void Clock::start() {
+    std::lock_guard<std::mutex> lock(tickerMutex);
+    if (tickerRunning.load()) {
+        return;
+    }
+    
+    refresh();
+    tickerRunning.store(true);
+    ticker = std::thread(tick);
+}
+
+void Clock::stop() {
+    std::lock_guard<std::mutex> lock(tickerMutex);
+    if (!tickerRunning.load()) {
+        return;
+    }
+    
+    tickerRunning.store(false);
+    if (ticker.joinable()) {
+        ticker.join();
+    }
+}
+
+int64_t Clock::now() {
+    if (tickerRunning.load(std::memory_order_relaxed)) {
+        return cachedNow.load(std::memory_order_relaxed);
+    }
+    return originEpochMillis + static_cast<int64_t>(elapsedMillis());
+}
+
+uint64_t Clock::ticks() {
+    if (tickerRunning.load(std::memory_order_relaxed)) {
+        return cachedTicks.load(std::memory_order_relaxed);
+    }
+    return elapsedMillis();
+}
+
+// "MM/DD/YYYY hh:mm:ss.mmm AM". The part before the milliseconds only changes
+// once a second, so each thread keeps the last one it built and reuses it.
+std::string Clock::format(int64_t epochMillis) {
+    thread_local int64_t cachedSecond = -1;
+    thread_local char prefix[32];
+    thread_local char suffix[8];
+    
+    int64_t second = epochMillis / 1000;
+    if (second != cachedSecond) {
+        std::time_t time = static_cast<std::time_t>(second);
+        std::tm local = *std::localtime(&time);
+        std::strftime(prefix, sizeof(prefix), "%m/%d/%Y %I:%M:%S", &local);
+        std::strftime(suffix, sizeof(suffix), " %p", &local);
+        cachedSecond = second;
+    }
+    
+    int ms = static_cast<int>(epochMillis % 1000);
+    char millis[5] = {'.', static_cast<char>('0' + ms / 100), static_cast<char>('0' + ms / 10 % 10),
+                      static_cast<char>('0' + ms % 10), '\0'};
+    return std::string(prefix) + millis + suffix;
+}
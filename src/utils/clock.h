@@ -0,0 +1,24 @@
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <string>
+#include <cstdint>
+
+// Process-wide time source. While the ticker runs, a background thread
+// refreshes a cached millisecond timestamp, so the interpreter reads the time
+// with a single atomic load. Timestamps stay numeric until they are shown;
+// format() turns one into the emulator's display form.
+class Clock {
+public:
+    static void start();
+    static void stop();
+    
+    // Wall-clock milliseconds since the epoch, derived from a monotonic clock.
+    static int64_t now();
+    // Milliseconds since the ticker was started.
+    static uint64_t ticks();
+    
+    static std::string format(int64_t epochMillis);
+};
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+
+// xoshiro256** with SplitMix64 seeding. The whole state is four words, so a
+// generator can be stored per process and saved in a checkpoint.
+class Xoshiro256 {
+public:
+    Xoshiro256() { seed(0); }
+    explicit Xoshiro256(uint64_t value) { seed(value); }
+
+    void seed(uint64_t value) {
+        for (auto& word : state) {
+            value += 0x9E3779B97F4A7C15ULL;
+            uint64_t z = value;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            word = z ^ (z >> 31);
+        }
+    }
+
+    uint64_t next() {
+        uint64_t result = rotl(state[1] * 5, 7) * 9;
+        uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    // Uniform integer in [min, max].
+    int range(int min, int max) {
+        uint64_t span = static_cast<uint64_t>(static_cast<int64_t>(max) - min) + 1;
+        return static_cast<int>(min + static_cast<int64_t>(next() % span));
+    }
+
+    uint64_t getState(int word) const { return state[word]; }
+    void setState(int word, uint64_t value) { state[word] = value; }
+
+private:
+    uint64_t state[4];
+
+    static uint64_t rotl(uint64_t value, int shift) {
+        return (value << shift) | (value >> (64 - shift));
+    }
+};
+
+#endif
@@ -1,22 +1,15 @@
 #include "utils.h"
+#include "random.h"
+#include "clock.h"
 #include <iostream>
 #include <sstream>
 #include <iomanip>
 #include <random>
+#include <atomic>
 
 namespace Utils {
     std::string getCurrentTimestamp() {
-        auto now = std::chrono::system_clock::now();
-        auto time_t = std::chrono::system_clock::to_time_t(now);
-        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-            now.time_since_epoch()) % 1000;
-        
-        std::stringstream ss;
-        ss << std::put_time(std::localtime(&time_t), "%m/%d/%Y %I:%M:%S");
-        ss << "." << std::setfill('0') << std::setw(3) << ms.count();
-        ss << std::put_time(std::localtime(&time_t), " %p");
-        
-        return ss.str();
+        return Clock::format(Clock::now());
     }
     
     void clearScreen() {
@@ -43,10 +36,45 @@ namespace Utils {
                std::to_string(ms.count()) + "s";
     }
     
+    namespace {
+        uint64_t randomBaseSeed() {
+            std::random_device rd;
+            return (static_cast<uint64_t>(rd()) << 32) | rd();
+        }
+        
+        std::atomic<uint64_t> baseSeed{randomBaseSeed()};
+        std::atomic<uint64_t> seedGeneration{0};
+        std::atomic<uint64_t> threadCounter{0};
+    }
+    
+    // Each thread draws from its own generator, reseeded whenever the run's
+    // base seed changes.
     int generateRandomInt(int min, int max) {
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
-        std::uniform_int_distribution<> dist(min, max);
-        return dist(gen);
+        thread_local Xoshiro256 gen;
+        thread_local uint64_t generation = UINT64_MAX;
+        
+        uint64_t current = seedGeneration.load();
+        if (generation != current) {
+            gen.seed(deriveSeed("thread-" + std::to_string(threadCounter.fetch_add(1))));
+            generation = current;
+        }
+        return gen.range(min, max);
+    }
+    
+    void setRandomSeed(uint64_t seed) {
+        baseSeed.store(seed);
+        threadCounter.store(0);
+        seedGeneration.fetch_add(1);
+    }
+    
+    // Seed for one named random stream (a process, the scheduler, a thread).
+    // With a fixed base seed the same stream name always gets the same seed.
+    uint64_t deriveSeed(const std::string& stream) {
+        uint64_t hash = 1469598103934665603ULL;
+        for (char c : stream) {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ULL;
+        }
+        return Xoshiro256(baseSeed.load() ^ hash).next();
     }
 }
@@ -3,6 +3,7 @@
 
 #include <string>
 #include <chrono>
+#include <cstdint>
 
 namespace Utils {
     std::string getCurrentTimestamp();
@@ -11,6 +12,8 @@ namespace Utils {
     void resetTextColor();
     std::string formatDuration(std::chrono::milliseconds duration);
     int generateRandomInt(int min, int max);
+    void setRandomSeed(uint64_t seed);
+    uint64_t deriveSeed(const std::string& stream);
 }
 
 #endif